@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    Audio thread allocation detector implementation
+
+  ==============================================================================
+*/
+
+#include "AllocationDetector.h"
+
+#if RSBM_DETECT_AUDIO_THREAD_ALLOCATIONS
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// initial-exec keeps the flag in static TLS, so reading it from inside malloc
+// can't itself call malloc when the plugin has been dlopen'd
+#if defined(__GNUC__) && ! defined(__APPLE__)
+ #define RSBM_TLS_MODEL __attribute__((tls_model("initial-exec")))
+#else
+ #define RSBM_TLS_MODEL
+#endif
+
+namespace
+{
+    thread_local int audioThreadDepth RSBM_TLS_MODEL { 0 };
+    
+    void checkAllocation(const char* function)
+    {
+        if (audioThreadDepth == 0)
+            return;
+        
+        // stop checking so reporting can't recurse into us
+        audioThreadDepth = 0;
+        
+        std::fputs("RSBrokenMedia: heap ", stderr);
+        std::fputs(function, stderr);
+        std::fputs(" on the audio thread\n", stderr);
+        
+        jassertfalse;
+        std::abort();
+    }
+    
+    void* checkedAllocate(std::size_t size, const char* function)
+    {
+        checkAllocation(function);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+    
+    void checkedFree(void* ptr, const char* function)
+    {
+        if (ptr != nullptr)
+            checkAllocation(function);
+        
+        std::free(ptr);
+    }
+}
+
+//==============================================================================
+void* operator new(std::size_t size)
+{
+    if (void* ptr = checkedAllocate(size, "operator new"))
+        return ptr;
+    
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* ptr = checkedAllocate(size, "operator new[]"))
+        return ptr;
+    
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return checkedAllocate(size, "operator new"); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return checkedAllocate(size, "operator new[]"); }
+
+void operator delete(void* ptr) noexcept { checkedFree(ptr, "operator delete"); }
+void operator delete[](void* ptr) noexcept { checkedFree(ptr, "operator delete[]"); }
+void operator delete(void* ptr, std::size_t) noexcept { checkedFree(ptr, "operator delete"); }
+void operator delete[](void* ptr, std::size_t) noexcept { checkedFree(ptr, "operator delete[]"); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { checkedFree(ptr, "operator delete"); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { checkedFree(ptr, "operator delete[]"); }
+
+//==============================================================================
+// glibc lets us wrap the C allocator too, which catches libgsm and anything
+// else calling malloc directly
+#if defined(__GLIBC__)
+extern "C"
+{
+    void* __libc_malloc(std::size_t);
+    void* __libc_calloc(std::size_t, std::size_t);
+    void* __libc_realloc(void*, std::size_t);
+    void __libc_free(void*);
+    
+    void* malloc(std::size_t size)
+    {
+        if (audioThreadDepth > 0)
+            checkAllocation("malloc");
+        
+        return __libc_malloc(size);
+    }
+    
+    void* calloc(std::size_t num, std::size_t size)
+    {
+        if (audioThreadDepth > 0)
+            checkAllocation("calloc");
+        
+        return __libc_calloc(num, size);
+    }
+    
+    void* realloc(void* ptr, std::size_t size)
+    {
+        if (audioThreadDepth > 0)
+            checkAllocation("realloc");
+        
+        return __libc_realloc(ptr, size);
+    }
+    
+    void free(void* ptr)
+    {
+        if (ptr != nullptr && audioThreadDepth > 0)
+            checkAllocation("free");
+        
+        __libc_free(ptr);
+    }
+}
+#endif
+#endif
+
+//==============================================================================
+ScopedAudioThreadAllocationCheck::ScopedAudioThreadAllocationCheck() noexcept
+{
+   #if RSBM_DETECT_AUDIO_THREAD_ALLOCATIONS
+    ++audioThreadDepth;
+   #endif
+}
+
+ScopedAudioThreadAllocationCheck::~ScopedAudioThreadAllocationCheck() noexcept
+{
+   #if RSBM_DETECT_AUDIO_THREAD_ALLOCATIONS
+    if (audioThreadDepth > 0)
+        --audioThreadDepth;
+   #endif
+}
+
+bool ScopedAudioThreadAllocationCheck::isActiveOnThisThread() noexcept
+{
+   #if RSBM_DETECT_AUDIO_THREAD_ALLOCATIONS
+    return audioThreadDepth > 0;
+   #else
+    return false;
+   #endif
+}
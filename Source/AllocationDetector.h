@@ -0,0 +1,33 @@
+/*
+  ==============================================================================
+
+    Audio thread allocation detector interface
+ - build with RSBM_DETECT_AUDIO_THREAD_ALLOCATIONS=1 (on in Debug configs)
+   to replace the global allocation functions with checking versions
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef RSBM_DETECT_AUDIO_THREAD_ALLOCATIONS
+ #define RSBM_DETECT_AUDIO_THREAD_ALLOCATIONS 0
+#endif
+
+// marks the calling thread as real-time for the lifetime of the object; with
+// detection enabled, any heap allocation or free made while one is alive
+// reports the offending call and aborts
+class ScopedAudioThreadAllocationCheck
+{
+public:
+    ScopedAudioThreadAllocationCheck() noexcept;
+    
+    ~ScopedAudioThreadAllocationCheck() noexcept;
+    
+    static bool isActiveOnThisThread() noexcept;
+    
+private:
+    JUCE_DECLARE_NON_COPYABLE(ScopedAudioThreadAllocationCheck)
+};
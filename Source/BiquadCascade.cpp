@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    Biquad cascade implementation
+
+  ==============================================================================
+*/
+
+#include "BiquadCascade.h"
+
+//==============================================================================
+void BiquadCascade::prepare(int numChannels, int maximumBlockSize, int numSections)
+{
+    mNumChannels = numChannels;
+    mNumGroups = (numChannels + mNumLanes - 1) / mNumLanes;
+
+    // pass-through until coefficients arrive
+    Section identity;
+    identity.b0 = Register::expand(1.0f);
+    identity.b1 = identity.b2 = identity.a1 = identity.a2 = Register::expand(0.0f);
+    mSections.assign(static_cast<size_t>(numSections), identity);
+
+    mState.resize(static_cast<size_t>(mNumGroups * numSections * 2));
+    mInterleaved.resize(static_cast<size_t>(std::max(1, maximumBlockSize)));
+
+    reset();
+}
+
+void BiquadCascade::setCoefficients(const juce::ReferenceCountedArray<Coefficients>& sections)
+{
+    jassert(sections.size() == static_cast<int>(mSections.size()));
+
+    for (int section = 0; section < std::min(sections.size(), static_cast<int>(mSections.size())); ++section)
+    {
+        // normalized by a0, so the raw order is b0 b1 b2 a1 a2
+        const auto* raw = sections.getObjectPointer(section)->getRawCoefficients();
+        auto& target = mSections[static_cast<size_t>(section)];
+
+        target.b0 = Register::expand(raw[0]);
+        target.b1 = Register::expand(raw[1]);
+        target.b2 = Register::expand(raw[2]);
+        target.a1 = Register::expand(raw[3]);
+        target.a2 = Register::expand(raw[4]);
+    }
+}
+
+void BiquadCascade::process(float* const* channels, int numChannels, int numSamples) noexcept
+{
+    juce::ScopedNoDenormals noDenormals;
+    numChannels = std::min(numChannels, mNumChannels);
+
+    const int maxChunk = static_cast<int>(mInterleaved.size());
+    auto* interleaved = reinterpret_cast<float*>(mInterleaved.data());
+
+    for (int group = 0; group * mNumLanes < numChannels; ++group)
+    {
+        const int firstChannel = group * mNumLanes;
+        const int numGroupChannels = std::min(mNumLanes, numChannels - firstChannel);
+
+        // chunks, in case the host sends more than it prepared us for
+        for (int start = 0; start < numSamples; start += maxChunk)
+        {
+            const int chunk = std::min(numSamples - start, maxChunk);
+
+            // unused lanes just filter silence
+            if (numGroupChannels < mNumLanes)
+                std::fill(interleaved, interleaved + chunk * mNumLanes, 0.0f);
+
+            for (int lane = 0; lane < numGroupChannels; ++lane)
+            {
+                const auto* source = channels[firstChannel + lane] + start;
+                for (int sample = 0; sample < chunk; ++sample)
+                    interleaved[sample * mNumLanes + lane] = source[sample];
+            }
+
+            processGroup(group, chunk);
+
+            for (int lane = 0; lane < numGroupChannels; ++lane)
+            {
+                auto* destination = channels[firstChannel + lane] + start;
+                for (int sample = 0; sample < chunk; ++sample)
+                    destination[sample] = interleaved[sample * mNumLanes + lane];
+            }
+        }
+    }
+
+    // once per block rather than after every sample
+    for (auto& state : mState)
+        for (size_t lane = 0; lane < Register::size(); ++lane)
+        {
+            auto value = state.get(lane);
+            JUCE_SNAP_TO_ZERO(value);
+            state.set(lane, value);
+        }
+}
+
+void BiquadCascade::reset() noexcept
+{
+    std::fill(mState.begin(), mState.end(), Register::expand(0.0f));
+}
+
+//==============================================================================
+// each section runs over the whole chunk before the next one starts
+void BiquadCascade::processGroup(int group, int numSamples) noexcept
+{
+    auto* data = mInterleaved.data();
+    auto* state = mState.data() + group * static_cast<int>(mSections.size()) * 2;
+
+    for (const auto& section : mSections)
+    {
+        Register s1 = state[0];
+        Register s2 = state[1];
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            const Register x = data[sample];
+            const Register y = section.b0 * x + s1;
+
+            s1 = section.b1 * x - section.a1 * y + s2;
+            s2 = section.b2 * x - section.a2 * y;
+
+            data[sample] = y;
+        }
+
+        state[0] = s1;
+        state[1] = s2;
+        state += 2;
+    }
+}
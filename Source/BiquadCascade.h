@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    Biquad cascade interface
+    - second-order sections run over whole blocks, with channels packed into
+      SIMD lanes so a stereo (or up to four channel) signal is one pass
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class BiquadCascade
+{
+public:
+    using Coefficients = juce::dsp::IIR::Coefficients<float>;
+
+    void prepare(int numChannels, int maximumBlockSize, int numSections);
+
+    // second-order sections as FilterDesign returns them; the filter state carries on
+    void setCoefficients(const juce::ReferenceCountedArray<Coefficients>& sections);
+
+    // filters the first numSamples of each channel in place
+    void process(float* const* channels, int numChannels, int numSamples) noexcept;
+
+    void reset() noexcept;
+
+private:
+    using Register = juce::dsp::SIMDRegister<float>;
+    static constexpr int mNumLanes { static_cast<int>(Register::size()) };
+
+    struct Section
+    {
+        Register b0, b1, b2, a1, a2;
+    };
+
+    void processGroup(int group, int numSamples) noexcept;
+
+    std::vector<Section> mSections;
+
+    // transposed direct form II state, two registers per section per channel group
+    std::vector<Register> mState;
+
+    // one channel group, interleaved sample by sample
+    std::vector<Register> mInterleaved;
+
+    int mNumChannels { 0 };
+    int mNumGroups { 0 };
+};
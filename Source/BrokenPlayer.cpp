@@ -17,12 +17,15 @@ RandomLoop::RandomLoop(int bufferLen, int countLen)
 
 void RandomLoop::init() { mCounter = 0; }
 
-std::vector<int> RandomLoop::advanceCtrAndReturn()
+const std::array<int, 2>& RandomLoop::advanceCtrAndReturn(int numSamples)
 {
     if (mCounter == 0)
     {
+        std::array<float, 2> uniforms;
+        mRandom.fillUniforms(uniforms.data(), static_cast<int>(uniforms.size()));
+        
         for (int i = 0; i < 2; ++i)
-            mLoopValues.at(i) = (randomFloat() * 64) * ((mBufferLength - 1) / 64);
+            mLoopValues.at(i) = (uniforms.at(i) * 64) * ((mBufferLength - 1) / 64);
         
         // normal distribution to 2 std dev - was supposed to make more
         // values close together but actually seemed to make glitches sparser
@@ -42,18 +45,25 @@ std::vector<int> RandomLoop::advanceCtrAndReturn()
         std::sort(mLoopValues.begin(), mLoopValues.end(), std::less<int>());
     }
     
-    ++mCounter;
+    // callers never advance past the next new loop
+    jassert(numSamples <= getSamplesUntilNewLoop());
+    
+    mCounter += numSamples;
     mCounter %= mCountLength;
     
     return mLoopValues;
 }
 
+int RandomLoop::getSamplesUntilNewLoop() const { return mCountLength - mCounter; }
+
 void RandomLoop::setBufferLength(int newBufferLen)
 {
     mBufferLength = std::clamp<int>(newBufferLen, 0, 352800, std::less<int>());
     mCounter = 0;
 }
 
+void RandomLoop::setSeed(uint64_t newSeed) { mRandom.setSeed(newSeed); }
+
 // cd skip
 //==============================================================================
 CDSkip::CDSkip(int bufferLen, int bufferDiv)
@@ -68,7 +78,7 @@ void CDSkip::init()
     mSegmentCounter = 0; //?
 }
 
-std::vector<int> CDSkip::advanceCtrAndReturn()
+const std::array<int, 2>& CDSkip::advanceCtrAndReturn()
 {
     if (mCounter == 0)
     {
@@ -145,7 +155,24 @@ void BrokenPlayer::prepareToPlay(double sampleRate, int samplesPerBlock)
         line.reset(getSampleRate());
     });
     
-    srand(static_cast<uint32_t>(time(NULL)));
+    juce::dsp::ProcessSpec distortionSpec = spec;
+    distortionSpec.numChannels = getTotalNumOutputChannels();
+    
+    mDistortions.prepare(distortionSpec);
+    setSaturationQuality(mSaturationKernel, mSaturationAntiAliasing);
+    
+    mRandom.setSeed(mRandomSeed.value_or(RandomGenerator::makeUniqueSeed()));
+    
+    std::for_each(mRandomLooper.begin(),
+                  mRandomLooper.end(),
+                  [this](RandomLoop& looper) { looper.setSeed(mRandom.nextUInt64()); });
+    
+    // one seed for every channel, as they share a transport
+    const uint64_t wowFlutterSeed = mRandom.nextUInt64();
+    
+    std::for_each(mWowFlutter.begin(),
+                  mWowFlutter.end(),
+                  [sampleRate, wowFlutterSeed](WowFlutter& wowFlutter) { wowFlutter.prepare(sampleRate, wowFlutterSeed); });
 }
 
 //==============================================================================
@@ -161,152 +188,225 @@ void BrokenPlayer::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuff
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-    //================ channel/sample loops ================
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = buffer.getNumChannels();
+    
+    for (int channel = 0; channel < numChannels; ++channel)
+        mCircularBuffer.fillNextBlock(channel, numSamples, buffer.getReadPointer(channel));
+    
+    //================ clock spans ================
+    // split the block at clock pulses, then render each channel between
+    // pulses as a series of event-free spans
+    int spanStart = 0;
+    int nextPulse = 0;
+    
+    while (spanStart < numSamples)
     {
-        auto* channelData = buffer.getWritePointer (channel);
-        
-        mCircularBuffer.fillNextBlock(channel, buffer.getNumSamples(), channelData);
+        int spanLength = numSamples - spanStart;
         
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        if (mShouldUseExternalClock == false)
         {
-            //================ clock, clocked settings ================
-            if (mShouldUseExternalClock == false)
+            if (mSamplesUntilClock <= 0)
             {
-                if (channel == 0)
-                {
-                    if (mClockCounter == 0)
-                    {
-                        receiveClockedPulse();
-                        ++mClockCounter;
-                    }
-                    else
-                    {
-                        ++mClockCounter;
-                        mClockCounter %= mClockCycle;
-                    }
-                }
-            }
-            
-            //================ tape speed adjustments ================
-            // ramp back up if stop completed
-            float tapeStopSpeed = mTapeStopLine.at(channel).renderAudioOutput();
-            if (tapeStopSpeed < 0.01)
-            {
-                mTapeStopLine.at(channel).setParameters(133);
-                mTapeStopLine.at(channel).setDestination(1.0f);
+                receiveClockedPulse();
+                mSamplesUntilClock = mClockCycle;
             }
             
-            mPlaybackRate.at(channel) = mTapeSpeedLine.at(channel).renderAudioOutput() * mTapeDirMultiplier;
-            mPlaybackRate.at(channel) *= tapeStopSpeed;
-            
-            //================ playback ================
-            //================ repeats ================
-            if (mNumRepeats > 1)
+            spanLength = std::min(spanLength, mSamplesUntilClock);
+            mSamplesUntilClock -= spanLength;
+        }
+        else
+        {
+            while (nextPulse < mNumScheduledPulses && mScheduledPulses[static_cast<size_t>(nextPulse)] <= spanStart)
             {
-                if (channel == 0 && mRepeatsCounter.at(channel) == 0)
-                    mRepeatsValues = mRepeater.advanceCtrAndReturn();
-                if (mRepeatsCounter.at(channel) == 0)
-                    mReadPosition.at(channel) = mRepeatsValues.at(0);
+                receiveClockedPulse();
+                ++nextPulse;
             }
             
-            //================ old tape skips ================
-//            if (skipProb.at(channel) < cdSkipProb)
-//            {
-//                std::vector<int> skipLoop;
-//
-//                // read (and start next slice if necessary) before incrementing and wrapping
-//                if (cdSkipPlayCounter.at(channel) == 0)
-//                {
-//                    skipLoop = cdSkipper.at(channel).advanceCtrAndReturn();
-//
-//                    mReadPosition.at(channel) = skipLoop.at(0);
-//                    mChirpReadPosition.at(channel) = skipLoop.at(0);
-//                    cdSkipPlayLength.at(channel) = skipLoop.at(1);
-//
-//                    channelData[sample] = mCircularBuffer.readSample(channel, mReadPosition.at(channel));
-//                }
-//                else
-//                {
-//                    channelData[sample] = mCircularBuffer.readSample(channel, mReadPosition.at(channel));
-//                }
-//
-//                // chirp
-//                if (cdSkipPlayCounter.at(channel) < 75)
-//                {
-//                    channelData[sample] += mCircularBuffer.readSample(channel, mChirpReadPosition.at(channel));
-//
-//                    mChirpReadPosition.at(channel) += 7;
-//                    mChirpReadPosition.at(channel) = wrap(mChirpReadPosition.at(channel), static_cast<float>(mBentBufferLength));
-//                }
-//
-//                // increment/wrap read position
-//                mReadPosition.at(channel) += mPlaybackRate.at(channel);
-//                mReadPosition.at(channel) = wrap(mReadPosition.at(channel), static_cast<float>(mBentBufferLength));
-//                // increment/wrap skip timing counter
-//                ++cdSkipPlayCounter.at(channel);
-//                cdSkipPlayCounter.at(channel) %= cdSkipPlayLength.at(channel);
-//            }
+            if (nextPulse < mNumScheduledPulses)
+                spanLength = std::min(spanLength, mScheduledPulses[static_cast<size_t>(nextPulse)] - spanStart);
+        }
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+            renderClockSpan(channel, buffer.getWritePointer(channel) + spanStart, spanLength);
+        
+        spanStart += spanLength;
+    }
+    
+    mNumScheduledPulses = 0;
+    
+    // select new distortion processor, if necessary - a change crossfades from
+    // the old one, and the next block's clocked pulses set up the new one
+    mDistortions.select(mCurrentDist);
+    
+    // apply correct distortion
+    if (mUseDist > 0)
+        mDistortions.process(buffer, midiMessages);
+}
 
-            //================ loops ================
-            if (mSkipProb.at(channel) < mRandomLoopProb)
-            {
-                std::vector<int> randomLoop = mRandomLooper.at(channel).advanceCtrAndReturn();
-                
-                channelData[sample] = mCircularBuffer.readSample(channel, mReadPosition.at(channel));
-                
-                // increment/wrap read position
-                mReadPosition.at(channel) += mPlaybackRate.at(channel);
-                mReadPosition.at(channel) = wrap(mReadPosition.at(channel), static_cast<float>(mBentBufferLength));
-                if (mReadPosition.at(channel) > randomLoop.at(1) )//|| mReadPosition.at(channel) < randomLoop.at(0))
-                    mReadPosition.at(channel) = randomLoop.at(0);
-            }
-            //================ advance, only loop at buffer seg. ================
-            else
-            {
-                channelData[sample] = mCircularBuffer.readSample(channel, mReadPosition.at(channel));
-                
-                mReadPosition.at(channel) += mPlaybackRate.at(channel);
-                mReadPosition.at(channel) = wrap(mReadPosition.at(channel), static_cast<float>(mBentBufferLength));
-            }
-            
-            // wrap repeats counter/value
-            if (mNumRepeats > 1)
-            {
-                ++mRepeatsCounter.at(channel);
-                if (mRepeatsCounter.at(channel) >= mRepeatsValues.at(1))
-                    mRepeatsCounter.at(channel) = 0;
-            }
-            
-        } // end sample loop
-    } // end channel loop
+//==============================================================================
+void BrokenPlayer::renderClockSpan(int channel, float* channelData, int numSamples)
+{
+    auto& speedLine = mTapeSpeedLine.at(channel);
+    auto& stopLine = mTapeStopLine.at(channel);
+    auto& looper = mRandomLooper.at(channel);
+    
+    // both only change on a clock pulse or between blocks
+    const bool isLooping = mSkipProb.at(channel) < mRandomLoopProb;
+    const bool isRepeating = mNumRepeats > 1;
+    
+    int sample = 0;
     
-    // new distortion processor, if necessary
-    if (mCurrentDist != mPrevDist)
+    while (sample < numSamples)
     {
-        mSlotProcessor = mDistortionFactory.create(mCurrentDist);
+        //================ repeats ================
+        if (isRepeating && mRepeatsCounter.at(channel) == 0)
+        {
+            if (channel == 0)
+                mRepeatsValues = mRepeater.advanceCtrAndReturn();
+            mReadPosition.at(channel) = mRepeatsValues.at(0);
+        }
+        
+        //================ distance to next event ================
+        int spanLength = numSamples - sample;
+        
+        if (isRepeating)
+            spanLength = std::min(spanLength, std::max(1, mRepeatsValues.at(1) - mRepeatsCounter.at(channel)));
+        
+        if (isLooping)
+            spanLength = std::min(spanLength, looper.getSamplesUntilNewLoop());
+        
+        spanLength = std::min(spanLength, getSamplesUntilTapeStop(stopLine));
+        
+        //================ playback ================
+        // renders the tape speed and stop ramps along with the audio
+        const std::array<int, 2>* loopPoints = isLooping ? &looper.advanceCtrAndReturn(spanLength) : nullptr;
+        
+        renderSpan(channel, channelData + sample, spanLength, loopPoints);
         
-        if (mSlotProcessor != nullptr)
+        //================ tape speed adjustments ================
+        // ramp back up if stop completed
+        if (stopLine.getCurrentValue() < mTapeStopThreshold)
         {
-            juce::dsp::ProcessSpec spec;
-            spec.sampleRate = getSampleRate();
-            spec.maximumBlockSize = buffer.getNumSamples();
-            spec.numChannels = buffer.getNumChannels();
-            
-            mSlotProcessor->prepare(spec);
+            stopLine.setParameters(133);
+            stopLine.setShape(rampShape::kLinear);
+            stopLine.setDestination(1.0f);
+        }
+        
+        // wrap repeats counter/value
+        if (isRepeating)
+        {
+            mRepeatsCounter.at(channel) += spanLength;
+            if (mRepeatsCounter.at(channel) >= mRepeatsValues.at(1))
+                mRepeatsCounter.at(channel) = 0;
         }
         
-        mPrevDist = mCurrentDist;
+        sample += spanLength;
     }
+}
+
+void BrokenPlayer::renderSpan(int channel, float* channelData, int numSamples, const std::array<int, 2>* loopPoints)
+{
+    auto& speedLine = mTapeSpeedLine.at(channel);
+    auto& stopLine = mTapeStopLine.at(channel);
     
-    // apply correct distortion
-    if (mUseDist > 0)
+    const float bufferLength = static_cast<float>(mBentBufferLength);
+    const float upperBound = loopPoints != nullptr ? std::min(static_cast<float>(loopPoints->at(1)), bufferLength) : bufferLength;
+    
+    auto& wowFlutter = mWowFlutter.at(channel);
+    
+    const bool isConstantRate = speedLine.getRemainingRampSamples() == 0 && stopLine.getRemainingRampSamples() == 0 && ! wowFlutter.isActive();
+    
+    float readPosition = mReadPosition.at(channel);
+    
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += mSpanChunkSize)
     {
-        if (mSlotProcessor != nullptr)
+        const int chunkLength = std::min(mSpanChunkSize, numSamples - chunkStart);
+        
+        // playback rate is the product of the two ramps and the wow & flutter
+        speedLine.renderBlock(mSpeedScratch.data(), chunkLength);
+        stopLine.renderBlock(mStopScratch.data(), chunkLength);
+        juce::FloatVectorOperations::multiply(mRateScratch.data(), mSpeedScratch.data(), mStopScratch.data(), chunkLength);
+        juce::FloatVectorOperations::multiply(mRateScratch.data(), mTapeDirMultiplier, chunkLength);
+        
+        if (wowFlutter.isActive())
+            wowFlutter.applyToBlock(mRateScratch.data(), chunkLength);
+        
+        // bounds of the rate over the chunk - the wobble isn't monotonic, so
+        // they come from the rates themselves rather than the ramps' end points
+        const auto rateRange = juce::FloatVectorOperations::findMinAndMax(mRateScratch.data(), chunkLength);
+        const float minRate = std::min(rateRange.getStart(), 0.0f);
+        const float maxRate = std::max(rateRange.getEnd(), 0.0f);
+        
+        int i = 0;
+        
+        while (i < chunkLength)
         {
-            mSlotProcessor->processBlock(buffer, midiMessages);
+            // samples that can be read before the position could wrap or leave the loop,
+            // keeping a sample clear of either edge to absorb rounding
+            int runLength = chunkLength - i;
+            
+            if (readPosition < 0.0f || readPosition >= upperBound)
+                runLength = 0;
+            if (maxRate > 0.0f)
+                runLength = std::min(runLength, static_cast<int>((upperBound - 1.0f - readPosition) / maxRate));
+            if (minRate < 0.0f)
+                runLength = std::min(runLength, static_cast<int>((readPosition - 1.0f) / -minRate));
+            
+            if (runLength > 0)
+            {
+                if (isConstantRate)
+                {
+                    readPosition = mCircularBuffer.readBlock(channel, readPosition, mRateScratch[i], runLength, channelData + chunkStart + i);
+                }
+                else
+                {
+                    for (int j = 0; j < runLength; ++j)
+                    {
+                        mPositionScratch[j] = readPosition;
+                        readPosition += mRateScratch[i + j];
+                    }
+                    
+                    mCircularBuffer.readBlock(channel, mPositionScratch.data(), runLength, channelData + chunkStart + i);
+                }
+                
+                i += runLength;
+            }
+            else
+            {
+                // a single sample with full wrap/loop handling
+                channelData[chunkStart + i] = mCircularBuffer.readSample(channel, readPosition, mRateScratch[i]);
+                
+                // increment/wrap read position
+                readPosition += mRateScratch[i];
+                readPosition = wrap(readPosition, bufferLength);
+                if (loopPoints != nullptr && readPosition > loopPoints->at(1))
+                    readPosition = loopPoints->at(0);
+                
+                ++i;
+            }
         }
+        
+        mPlaybackRate.at(channel) = mRateScratch[chunkLength - 1];
     }
+    
+    mReadPosition.at(channel) = readPosition;
+}
+
+int BrokenPlayer::getSamplesUntilTapeStop(const Line<float>& line) const
+{
+    const int remaining = line.getRemainingRampSamples();
+    
+    // holding still: either stopped already, or never will be this span
+    if (remaining == 0)
+        return line.getDestination() < mTapeStopThreshold ? 1 : std::numeric_limits<int>::max();
+    
+    // ramping up - renderSpan() follows it past the end of the ramp
+    if (line.getDestination() > line.getCurrentValue())
+        return std::numeric_limits<int>::max();
+    
+    // ramping down - span ends on the first sample below the stop threshold
+    return std::clamp(line.getSamplesUntilCrossing(mTapeStopThreshold), 1, remaining);
 }
 
 //==============================================================================
@@ -317,6 +417,8 @@ void BrokenPlayer::reset()
         mTapeSpeedLine.at(line).reset(getSampleRate());
         mTapeStopLine.at(line).reset(getSampleRate());
     }
+    
+    std::for_each(mWowFlutter.begin(), mWowFlutter.end(), [](WowFlutter& wowFlutter) { wowFlutter.reset(); });
 }
 
 //==============================================================================
@@ -340,20 +442,27 @@ void BrokenPlayer::setStateInformation(const void*, int) {}
 //==============================================================================
 void BrokenPlayer::receiveClockedPulse()
 {
+    // every decision below draws from this block, in order
+    mRandom.fillUniforms(mPulseUniforms.data(), static_cast<int>(mPulseUniforms.size()));
+    auto uniform = mPulseUniforms.cbegin();
+    
     //================ L/R tape speed destinations ================
     std::for_each(mTapeSpeedLine.begin(),
                   mTapeSpeedLine.end(),
-                  [this](Line<float>& line)
+                  [this, &uniform](Line<float>& line)
                   {
-        if (randomFloat() < mTapeBendProb)
+        const float bendChance = *uniform++;
+        const float bendChoice = *uniform++;
+        
+        if (bendChance < mTapeBendProb)
         {
-            int index = rand() % mTapeBendDepth;
+            int index = static_cast<int>(bendChoice * mTapeBendDepth);
             float dest = mTapeBendVals.at(index);
             line.setDestination(dest);
         }
     });
     
-    if (randomFloat() < mTapeRevProb)
+    if (*uniform++ < mTapeRevProb)
         mTapeDirMultiplier = -1;
     else
         mTapeDirMultiplier = 1;
@@ -361,11 +470,12 @@ void BrokenPlayer::receiveClockedPulse()
     //================ L/R tape stops ================
     std::for_each(mTapeStopLine.begin(),
                   mTapeStopLine.end(),
-                  [this](Line<float>& line)
+                  [this, &uniform](Line<float>& line)
                   {
-        if (randomFloat() < mTapeStopProb)
+        if (*uniform++ < mTapeStopProb)
         {
             line.setParameters(mRampTime);
+            line.setShape(rampShape::kExponential);
             line.setDestination(0);
         }
     });
@@ -373,25 +483,25 @@ void BrokenPlayer::receiveClockedPulse()
     //================ skip/loop probs ================
     std::for_each(mSkipProb.begin(),
                   mSkipProb.end(),
-                  [this](float& prob){ prob = randomFloat(); });
+                  [&uniform](float& prob){ prob = *uniform++; });
     
     //================ distortion FX ================
     // dist
-    mUseDist = (randomFloat() < std::clamp<float>(mDistortionProb * 3, 0.0, 1.0, [](const float& a, const float& b) { return a < b; }));
+    mUseDist = (*uniform++ < std::clamp<float>(mDistortionProb * 3, 0.0, 1.0, [](const float& a, const float& b) { return a < b; }));
     
     float scaledProb = powf(mDistortionProb, 3.0f);
     
-    if (mSlotProcessor != nullptr)
+    if (auto* slotParameters = mDistortions.getParameters(mDistortions.getSelected()))
     {
-        mDistortionParameters = mSlotProcessor->getParameters();
+        mDistortionParameters = *slotParameters;
         
-        mDistortionParameters.bitDepth = static_cast<int>(floor( scale(scaledProb * -1 + 1, 0.0f, 1.0f, 5.0f, 12.0f) + 0.5) + (randomFloat() * 3));
+        mDistortionParameters.bitDepth = static_cast<int>(floor( scale(scaledProb * -1 + 1, 0.0f, 1.0f, 5.0f, 12.0f) + 0.5) + (*uniform++ * 3));
         
-        mDistortionParameters.downsampling = static_cast<int>( scale(scaledProb, 0.0f, 1.0f, 2.0f, 15.0f) + (randomFloat() * (1 + (scaledProb * 16))) );
+        mDistortionParameters.downsampling = static_cast<int>( scale(scaledProb, 0.0f, 1.0f, 2.0f, 15.0f) + (*uniform++ * (1 + (scaledProb * 16))) );
         
-        mDistortionParameters.drive = scale(mDistortionProb, 0.0f, 1.0f, 3.0f, 15.0f) + (randomFloat() * mDistortionProb * 21.0f);
+        mDistortionParameters.drive = scale(mDistortionProb, 0.0f, 1.0f, 3.0f, 15.0f) + (*uniform++ * mDistortionProb * 21.0f);
         
-        mSlotProcessor->setParameters(mDistortionParameters);
+        mDistortions.setParameters(mDistortions.getSelected(), mDistortionParameters);
     }
 }
 //==============================================================================
@@ -414,6 +524,10 @@ void BrokenPlayer::setAnalogFX(float newAnalogFX)
     mTapeRevProb = std::clamp<float>(newAnalogFX * 1.5, 0.0, 0.8, std::less<float>());
     
     mTapeStopProb = 0.4 * powf(newAnalogFX, 1.5);
+    
+    std::for_each(mWowFlutter.begin(),
+                  mWowFlutter.end(),
+                  [newAnalogFX](WowFlutter& wowFlutter) { wowFlutter.setDepth(powf(newAnalogFX, 2.0f)); });
 }
 void BrokenPlayer::setDigitalFX(float newDigitalFX)
 {
@@ -452,6 +566,29 @@ void BrokenPlayer::newNumRepeats(int newRepeatCount)
     mNumRepeats = newRepeatCount;
     //});
 }
-void BrokenPlayer::setClockSpeed(int newClockSpeed) { mClockCycle = newClockSpeed; }
+void BrokenPlayer::setClockSpeed(int newClockSpeed)
+{
+    mClockCycle = std::max(1, newClockSpeed);
+    mSamplesUntilClock = std::min(mSamplesUntilClock, mClockCycle);
+}
 //void BrokenPlayer::setClockSpeed(float newClockSpeed) { clockPeriod = newClockSpeed; }
 void BrokenPlayer::useExternalClock(bool newShouldUseExternalClock) { mShouldUseExternalClock = newShouldUseExternalClock; }
+void BrokenPlayer::scheduleClockedPulse(int sampleOffset)
+{
+    if (mNumScheduledPulses < mMaxScheduledPulses)
+        mScheduledPulses[static_cast<size_t>(mNumScheduledPulses++)] = std::max(0, sampleOffset);
+}
+void BrokenPlayer::setInterpolationQuality(interpolationQuality newQuality) { mCircularBuffer.setInterpolationQuality(newQuality); }
+void BrokenPlayer::setSaturationQuality(saturationKernel newKernel, bool shouldAntiAlias)
+{
+    mSaturationKernel = newKernel;
+    mSaturationAntiAliasing = shouldAntiAlias;
+    
+    // the clocked pulse copies these along with the rest of the processor's parameters
+    auto& saturation = mDistortions.get<SaturationProcessor>();
+    auto params = saturation.getParameters();
+    params.kernel = newKernel;
+    params.antiAliasing = shouldAntiAlias;
+    saturation.setParameters(params);
+}
+void BrokenPlayer::setRandomSeed(std::optional<uint64_t> newSeed) { mRandomSeed = newSeed; }
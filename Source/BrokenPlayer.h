@@ -15,25 +15,8 @@
 #include "Modulators.h"
 #include "Utilities.h"
 
-struct DistortionFactory
-{
-    std::unique_ptr<LofiProcessorBase> create(int type)
-    {
-        auto iter = processorMapping.find(type);
-        if (iter != processorMapping.end())
-            return iter->second();
-        
-        return nullptr;
-    }
-    
-    std::map<int,
-             std::function<std::unique_ptr<LofiProcessorBase>()>> processorMapping
-    {
-        { 0, []() { return std::make_unique<Bitcrusher>(); } },
-        { 1, []() { return std::make_unique<SaturationProcessor>(); } }/*,
-        { 2, []() { return std::make_unique<ChebyDrive>(); } }*/
-    };
-};
+// the "Dist Menu", in order
+using DistortionRegistry = LofiProcessorRegistry<0, Bitcrusher, SaturationProcessor/*, ChebyDrive*/>;
 
 //==============================================================================
 class RandomLoop
@@ -45,12 +28,18 @@ public:
     
     void init();
     
-    std::vector<int> advanceCtrAndReturn();
+    // picks new loop points if due, then advances the counter by numSamples
+    const std::array<int, 2>& advanceCtrAndReturn(int numSamples = 1);
+    
+    int getSamplesUntilNewLoop() const;
     
     void setBufferLength(int newBufferLen);
     
+    void setSeed(uint64_t newSeed);
+    
 private:
-    std::vector<int> mLoopValues { 0, 4410 };
+    RandomGenerator mRandom;
+    std::array<int, 2> mLoopValues { 0, 4410 };
     int mBufferLength = 44100;
     int mCountLength = 4410;
     int mCounter = 0;
@@ -64,14 +53,14 @@ public:
     
     void init();
     
-    std::vector<int> advanceCtrAndReturn();
+    const std::array<int, 2>& advanceCtrAndReturn();
     
     void setBufferLength(int newBufferLen);
     
     void setBufferDivisions(int newNumDivisions);
     
 private:
-    std::vector<int> mLoopValues { 0, 4410 };
+    std::array<int, 2> mLoopValues { 0, 4410 };
     int mBufferLength = 44100;
     int mBufferDivisions = 8;
     int mBufferSegmentLength = 4410;
@@ -112,6 +101,9 @@ public:
     
     //==============================================================================
     void receiveClockedPulse();
+    // with the external clock, a pulse sampleOffset samples into the next
+    // processBlock(); offsets go in ascending order, and any past the block are dropped
+    void scheduleClockedPulse(int sampleOffset);
     //==============================================================================
     void setAnalogFX(float newAnalogFX);
     void setDigitalFX(float newDigitalFX);
@@ -121,8 +113,17 @@ public:
     void newNumRepeats(int newRepeatCount);
     void setClockSpeed(int newClockSpeed);
     void useExternalClock(bool shouldUseExternalClock);
+    void setInterpolationQuality(interpolationQuality newQuality);
+    void setSaturationQuality(saturationKernel newKernel, bool shouldAntiAlias);
+    // a fixed seed makes every prepareToPlay() replay the same glitches; nullopt reseeds uniquely
+    void setRandomSeed(std::optional<uint64_t> newSeed);
     
 private:
+    void renderClockSpan(int channel, float* channelData, int numSamples);
+    void renderSpan(int channel, float* channelData, int numSamples, const std::array<int, 2>* loopPoints);
+    int getSamplesUntilTapeStop(const Line<float>& line) const;
+    
+
     int mBentBufferLength { 66150 }; // length of full 8s buffer to use
     CircularBuffer<float> mCircularBuffer { 353312 }; // 8 seconds + 512 samples for safety
     
@@ -130,22 +131,38 @@ private:
     std::vector<float> mPlaybackRate { 1.0, 1.0 };
     //    std::vector<float> mChirpReadPosition { 0.0, 0.0 };
     
-    OscillatorParameters mLfoParameters;
-    SignalGenData<float> mLfoOutput;
+    // randomness - every pulse's decisions are drawn as one block
+    RandomGenerator mRandom;
+    std::optional<uint64_t> mRandomSeed;
+    std::array<float, 16> mPulseUniforms {};
+    
+    // span scratch
+    static constexpr int mSpanChunkSize { 256 };
+    std::array<float, mSpanChunkSize> mRateScratch {};
+    std::array<float, mSpanChunkSize> mSpeedScratch {};
+    std::array<float, mSpanChunkSize> mStopScratch {};
+    std::array<float, mSpanChunkSize> mPositionScratch {};
     
     // clock
-    int mClockCounter { 0 };
+    int mSamplesUntilClock { 0 };
     int mClockCycle { 33075 };
     bool mIsTransportPlaying { false };
     juce::AudioPlayHead* mAudioPlayHead { nullptr };
     juce::Optional<juce::AudioPlayHead::PositionInfo> mPositionInfo;
     bool mShouldUseExternalClock { false };
     
+    // external pulses for the coming block - 1/16 notes at 300 BPM and 8192-sample blocks fit
+    static constexpr int mMaxScheduledPulses { 64 };
+    std::array<int, mMaxScheduledPulses> mScheduledPulses {};
+    int mNumScheduledPulses { 0 };
+    
     // tape FX
     std::vector<Line<float>> mTapeSpeedLine { Line<float>(), Line<float>()};
     std::vector<Line<float>> mTapeStopLine { Line<float>(), Line<float>()};
     float mRampTime { 6615 };
+    static constexpr float mTapeStopThreshold { 0.01f }; // stop ramp level that counts as stopped
     std::vector<float> mTapeBendVals { 1.0, 0.67, 1.5, 0.5, 2.0 };
+    std::vector<WowFlutter> mWowFlutter { WowFlutter(), WowFlutter() };
     float mTapeDirMultiplier { 1 };
     
     // digital FX
@@ -155,7 +172,7 @@ private:
     std::vector<RandomLoop> mRandomLooper { RandomLoop(mBentBufferLength, 3308), RandomLoop(mBentBufferLength, 4410) };
     std::vector<float> mSkipProb { 0, 0 };
     CDSkip mRepeater { mBentBufferLength, 8 };
-    std::vector<int> mRepeatsValues { 0, 4410 };
+    std::array<int, 2> mRepeatsValues { 0, 4410 };
     std::vector<int> mRepeatsCounter = { 0, 0 };
     std::vector<int> mRepeatsPlaybackCounter { 0, 0 };
     int mNumRepeats { 1 };
@@ -176,10 +193,12 @@ private:
     // distortion processor values
     bool mUseDist { false };
     int mCurrentDist { 0 };
-    int mPrevDist { -1 };
     LofiProcessorParameters mDistortionParameters;
     
-    // distortion processors
-    DistortionFactory mDistortionFactory {};
-    std::unique_ptr<LofiProcessorBase> mSlotProcessor = std::unique_ptr<LofiProcessorBase> {};
+    // distortion processors - all held in place and prepared in prepareToPlay, only selected on the audio thread
+    DistortionRegistry mDistortions;
+    
+    // kept so a re-prepared processor gets them back
+    saturationKernel mSaturationKernel { saturationKernel::kTanh };
+    bool mSaturationAntiAliasing { false };
 };
@@ -17,6 +17,8 @@ CircularBuffer<SampleType>::CircularBuffer(int bufferSize)
     mCircularBuffer.setSize(static_cast<int>(mCircularBuffer.getNumChannels()), mTotalSize, false, false, false);
     mCircularBuffer.clear();
     mNumSamples = mCircularBuffer.getNumSamples();
+    
+    buildSincTable();
 }
 
 //==============================================================================
@@ -65,26 +67,420 @@ void CircularBuffer<SampleType>::fillNextBlock(int channel, const int inBufferLe
 
 //==============================================================================
 template <typename SampleType>
-const SampleType CircularBuffer<SampleType>::readSample(int channel, SampleType readPosition)
+const SampleType CircularBuffer<SampleType>::readSample(int channel, SampleType readPosition, SampleType rate) const
+{
+    return interpolateWrapped(mCircularBuffer.getReadPointer(channel), readPosition, getSincBand(rate));
+}
+
+//==============================================================================
+template <typename SampleType>
+SampleType CircularBuffer<SampleType>::readBlock(int channel, SampleType startPosition, SampleType rate, int numSamples, SampleType* dest) const
 {
-    // look at DelayLine implementation
-    mReadPosFrac = readPosition - floor(readPosition);
-    mReadPosInt = static_cast<int>(floor(readPosition));
+    const auto* data = mCircularBuffer.getReadPointer(channel);
+    const auto segmentLength = static_cast<SampleType>(mUsedSegmentLength);
+    const int band = getSincBand(rate);
     
-    int index1 = mReadPosInt;
-    int index2 = mReadPosInt + 1;
+    // a sample of slack either side absorbs rounding in start + n * rate
+    const auto lowerBound = static_cast<SampleType>(mTapsBefore + 1);
+    const auto upperBound = static_cast<SampleType>(mUsedSegmentLength - mTapsAfter - 1);
     
-    if (index2 >= mUsedSegmentLength)
+    int sample = 0;
+    
+    while (sample < numSamples)
     {
-        index1 %= mUsedSegmentLength;
-        index2 %= mUsedSegmentLength;
+        // work in [0, segment length) so each contiguous span is a straight read -
+        // recomputed from the start rather than accumulated, so slow rates don't drift
+        SampleType position = std::fmod(startPosition + static_cast<SampleType>(sample) * rate, segmentLength);
+        if (position < 0)
+            position += segmentLength;
+        
+        // samples before the kernel would straddle the wrap point
+        int spanLength = numSamples - sample;
+        
+        if (position < lowerBound || position >= upperBound)
+            spanLength = 0;
+        else if (rate > 0)
+            spanLength = std::min(spanLength, static_cast<int>((upperBound - position) / rate));
+        else if (rate < 0)
+            spanLength = std::min(spanLength, static_cast<int>((position - lowerBound) / -rate));
+        
+        if (spanLength > 0)
+        {
+            interpolateContiguous(data, position, rate, spanLength, band, dest + sample);
+        }
+        else
+        {
+            dest[sample] = interpolateWrapped(data, position, band);
+            spanLength = 1;
+        }
+        
+        sample += spanLength;
     }
+    
+    return startPosition + static_cast<SampleType>(numSamples) * rate;
+}
+
+template <typename SampleType>
+void CircularBuffer<SampleType>::readBlock(int channel, const SampleType* positions, int numSamples, SampleType* dest) const
+{
+    const auto* data = mCircularBuffer.getReadPointer(channel);
+    int sample = 0;
+    
+    // the sinc band follows the fastest step through the block
+    int band = 0;
+    
+    if (mInterpolation == interpolationQuality::kSinc)
+    {
+        SampleType maxStep = 0;
+        for (int i = 1; i < numSamples; ++i)
+            maxStep = std::max(maxStep, std::abs(positions[i] - positions[i - 1]));
+        band = getSincBand(maxStep);
+    }
+    
+   #if JUCE_USE_SSE_INTRINSICS
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        const __m128i firstIndex = _mm_set1_epi32(mTapsBefore);
+        const __m128i lastIndex = _mm_set1_epi32(mUsedSegmentLength - 1 - mTapsAfter);
+        alignas(16) int indices[4];
+        alignas(16) float fracs[4];
+        
+        for (; sample + 4 <= numSamples; sample += 4)
+        {
+            const __m128 position = _mm_loadu_ps(positions + sample);
+            const __m128i index = _mm_cvttps_epi32(position);
+            
+            // any lane whose kernel crosses the wrap point (or the start) takes the scalar route
+            const __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(index, lastIndex), _mm_cmplt_epi32(index, firstIndex));
             
-    SampleType value1 = mCircularBuffer.getSample(channel, index1);
-    SampleType value2 = mCircularBuffer.getSample(channel, index2);
+            if (_mm_movemask_epi8(outside) != 0)
+            {
+                for (int lane = 0; lane < 4; ++lane)
+                    dest[sample + lane] = interpolateWrapped(data, positions[sample + lane], band);
+                continue;
+            }
+            
+            _mm_store_si128(reinterpret_cast<__m128i*>(indices), index);
+            _mm_store_ps(fracs, _mm_sub_ps(position, _mm_cvtepi32_ps(index)));
+            
+            interpolateLanes(data, indices, fracs, band, dest + sample);
+        }
+    }
+   #endif
     
-    // add difference between samples scaled by position between them
-    return value1 + (mReadPosFrac * (value2 - value1));
+    for (; sample < numSamples; ++sample)
+        dest[sample] = interpolateWrapped(data, positions[sample], band);
+}
+
+//==============================================================================
+template <typename SampleType>
+void CircularBuffer<SampleType>::setInterpolationQuality(interpolationQuality newQuality)
+{
+    mInterpolation = newQuality;
+    
+    switch (mInterpolation)
+    {
+        case interpolationQuality::kLinear:
+            mTapsBefore = 0;
+            mTapsAfter = 1;
+            break;
+        case interpolationQuality::kHermite:
+        case interpolationQuality::kLagrange:
+            mTapsBefore = 1;
+            mTapsAfter = 2;
+            break;
+        case interpolationQuality::kSinc:
+            mTapsBefore = mSincMaxTaps / 2 - 1;
+            mTapsAfter = mSincMaxTaps / 2;
+            break;
+    }
+}
+
+template <typename SampleType>
+interpolationQuality CircularBuffer<SampleType>::getInterpolationQuality() const { return mInterpolation; }
+
+//==============================================================================
+template <typename SampleType>
+void CircularBuffer<SampleType>::buildSincTable()
+{
+    constexpr double pi = juce::MathConstants<double>::pi;
+    constexpr double kaiserBeta = 7.0;
+    
+    // zeroth-order modified Bessel function, for the Kaiser window
+    const auto besselI0 = [](double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    };
+    
+    mSincTable.assign(mSincBandTaps.size() * (mSincPhases + 1) * mSincMaxTaps, 0);
+    
+    for (size_t band = 0; band < mSincBandTaps.size(); ++band)
+    {
+        const int numTaps = mSincBandTaps[band];
+        const double halfLength = numTaps / 2;
+        
+        // cutoff relative to the source Nyquist, pulled down so the fastest rate in the band doesn't alias
+        const double cutoff = 0.87 / mSincBandRates[band];
+        
+        for (int phase = 0; phase <= mSincPhases; ++phase)
+        {
+            auto* row = mSincTable.data() + (band * (mSincPhases + 1) + phase) * mSincMaxTaps;
+            const double frac = static_cast<double>(phase) / mSincPhases;
+            double sum = 0.0;
+            
+            for (int tap = 0; tap < numTaps; ++tap)
+            {
+                const double x = (tap - (halfLength - 1)) - frac;
+                const double sinc = x == 0.0 ? 1.0 : std::sin(pi * cutoff * x) / (pi * cutoff * x);
+                const double ratio = std::clamp(x / halfLength, -1.0, 1.0);
+                const double window = besselI0(kaiserBeta * std::sqrt(1.0 - ratio * ratio)) / besselI0(kaiserBeta);
+                
+                row[tap] = static_cast<SampleType>(sinc * window);
+                sum += sinc * window;
+            }
+            
+            // unity gain at DC for every phase
+            for (int tap = 0; tap < numTaps; ++tap)
+                row[tap] = static_cast<SampleType>(row[tap] / sum);
+        }
+    }
+}
+
+template <typename SampleType>
+int CircularBuffer<SampleType>::getSincBand(SampleType rate) const
+{
+    const auto speed = std::abs(static_cast<double>(rate));
+    
+    for (size_t band = 0; band < mSincBandRates.size() - 1; ++band)
+        if (speed <= mSincBandRates[band])
+            return static_cast<int>(band);
+    
+    return static_cast<int>(mSincBandRates.size() - 1);
+}
+
+//==============================================================================
+template <typename SampleType>
+SampleType CircularBuffer<SampleType>::interpolate(const SampleType* taps, SampleType frac, int band) const
+{
+    switch (mInterpolation)
+    {
+        case interpolationQuality::kLinear:
+            return taps[0] + (frac * (taps[1] - taps[0]));
+        
+        case interpolationQuality::kHermite:
+        {
+            // 4-point, 3rd-order Hermite (Catmull-Rom)
+            const SampleType c1 = static_cast<SampleType>(0.5) * (taps[1] - taps[-1]);
+            const SampleType c2 = taps[-1] - static_cast<SampleType>(2.5) * taps[0] + 2 * taps[1] - static_cast<SampleType>(0.5) * taps[2];
+            const SampleType c3 = static_cast<SampleType>(0.5) * (taps[2] - taps[-1]) + static_cast<SampleType>(1.5) * (taps[0] - taps[1]);
+            return ((c3 * frac + c2) * frac + c1) * frac + taps[0];
+        }
+        
+        case interpolationQuality::kLagrange:
+        {
+            // 4-point, 3rd-order Lagrange over taps -1 to 2
+            const SampleType fracMinusOne = frac - 1;
+            const SampleType fracMinusTwo = frac - 2;
+            const SampleType fracPlusOne = frac + 1;
+            const SampleType outer = frac * fracMinusOne;
+            const SampleType inner = fracPlusOne * fracMinusTwo;
+            
+            return taps[-1] * (outer * fracMinusTwo * static_cast<SampleType>(-1.0 / 6.0))
+                 + taps[0] * (inner * fracMinusOne * static_cast<SampleType>(0.5))
+                 + taps[1] * (inner * frac * static_cast<SampleType>(-0.5))
+                 + taps[2] * (outer * fracPlusOne * static_cast<SampleType>(1.0 / 6.0));
+        }
+        
+        case interpolationQuality::kSinc:
+            return interpolateSinc(taps, frac, band);
+    }
+    
+    return taps[0];
+}
+
+template <typename SampleType>
+SampleType CircularBuffer<SampleType>::interpolateSinc(const SampleType* taps, SampleType frac, int band) const
+{
+    const int numTaps = mSincBandTaps[static_cast<size_t>(band)];
+    const auto* first = taps - (numTaps / 2 - 1);
+    
+    // linear interpolation between the two nearest phases
+    const SampleType phase = frac * mSincPhases;
+    const int row = std::clamp(static_cast<int>(phase), 0, mSincPhases - 1);
+    const SampleType rowFrac = phase - static_cast<SampleType>(row);
+    
+    const auto* coeffs1 = mSincTable.data() + (band * (mSincPhases + 1) + row) * mSincMaxTaps;
+    const auto* coeffs2 = coeffs1 + mSincMaxTaps;
+    
+   #if JUCE_USE_SSE_INTRINSICS
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        const __m128 rowFracs = _mm_set1_ps(rowFrac);
+        __m128 sum = _mm_setzero_ps();
+        
+        // every band is a multiple of four taps
+        for (int tap = 0; tap < numTaps; tap += 4)
+        {
+            const __m128 c1 = _mm_loadu_ps(coeffs1 + tap);
+            const __m128 c2 = _mm_loadu_ps(coeffs2 + tap);
+            const __m128 coeffs = _mm_add_ps(c1, _mm_mul_ps(rowFracs, _mm_sub_ps(c2, c1)));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(first + tap), coeffs));
+        }
+        
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+    }
+   #endif
+    
+    SampleType sum = 0;
+    for (int tap = 0; tap < numTaps; ++tap)
+        sum += first[tap] * (coeffs1[tap] + rowFrac * (coeffs2[tap] - coeffs1[tap]));
+    
+    return sum;
+}
+
+template <typename SampleType>
+void CircularBuffer<SampleType>::interpolateLanes(const SampleType* data, const int* indices, const SampleType* fracs, int band, SampleType* dest) const
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        // tap n of each lane's kernel
+        const auto gather = [data, indices](int n)
+        {
+            return _mm_setr_ps(data[indices[0] + n], data[indices[1] + n], data[indices[2] + n], data[indices[3] + n]);
+        };
+        const auto constant = [](float value) { return _mm_set1_ps(value); };
+        
+        const __m128 frac = _mm_loadu_ps(fracs);
+        
+        switch (mInterpolation)
+        {
+            case interpolationQuality::kLinear:
+            {
+                const __m128 x0 = gather(0);
+                _mm_storeu_ps(dest, _mm_add_ps(x0, _mm_mul_ps(frac, _mm_sub_ps(gather(1), x0))));
+                return;
+            }
+            
+            case interpolationQuality::kHermite:
+            {
+                const __m128 xm1 = gather(-1);
+                const __m128 x0 = gather(0);
+                const __m128 x1 = gather(1);
+                const __m128 x2 = gather(2);
+                
+                const __m128 c1 = _mm_mul_ps(constant(0.5f), _mm_sub_ps(x1, xm1));
+                const __m128 c2 = _mm_sub_ps(_mm_add_ps(xm1, _mm_mul_ps(constant(2.0f), x1)),
+                                             _mm_add_ps(_mm_mul_ps(constant(2.5f), x0), _mm_mul_ps(constant(0.5f), x2)));
+                const __m128 c3 = _mm_add_ps(_mm_mul_ps(constant(0.5f), _mm_sub_ps(x2, xm1)),
+                                             _mm_mul_ps(constant(1.5f), _mm_sub_ps(x0, x1)));
+                
+                __m128 result = _mm_add_ps(_mm_mul_ps(c3, frac), c2);
+                result = _mm_add_ps(_mm_mul_ps(result, frac), c1);
+                result = _mm_add_ps(_mm_mul_ps(result, frac), x0);
+                _mm_storeu_ps(dest, result);
+                return;
+            }
+            
+            case interpolationQuality::kLagrange:
+            {
+                const __m128 fracMinusOne = _mm_sub_ps(frac, constant(1.0f));
+                const __m128 fracMinusTwo = _mm_sub_ps(frac, constant(2.0f));
+                const __m128 fracPlusOne = _mm_add_ps(frac, constant(1.0f));
+                const __m128 outer = _mm_mul_ps(frac, fracMinusOne);
+                const __m128 inner = _mm_mul_ps(fracPlusOne, fracMinusTwo);
+                
+                __m128 result = _mm_mul_ps(gather(-1), _mm_mul_ps(outer, _mm_mul_ps(fracMinusTwo, constant(-1.0f / 6.0f))));
+                result = _mm_add_ps(result, _mm_mul_ps(gather(0), _mm_mul_ps(inner, _mm_mul_ps(fracMinusOne, constant(0.5f)))));
+                result = _mm_add_ps(result, _mm_mul_ps(gather(1), _mm_mul_ps(inner, _mm_mul_ps(frac, constant(-0.5f)))));
+                result = _mm_add_ps(result, _mm_mul_ps(gather(2), _mm_mul_ps(outer, _mm_mul_ps(fracPlusOne, constant(1.0f / 6.0f)))));
+                _mm_storeu_ps(dest, result);
+                return;
+            }
+            
+            case interpolationQuality::kSinc:
+                // vectorised across taps instead of lanes
+                break;
+        }
+    }
+   #endif
+    
+    for (int lane = 0; lane < 4; ++lane)
+        dest[lane] = interpolate(data + indices[lane], fracs[lane], band);
+}
+
+template <typename SampleType>
+SampleType CircularBuffer<SampleType>::interpolateWrapped(const SampleType* data, SampleType readPosition, int band) const
+{
+    const SampleType readPosFloor = std::floor(readPosition);
+    const SampleType readPosFrac = readPosition - readPosFloor;
+    
+    int index = static_cast<int>(readPosFloor) % mUsedSegmentLength;
+    if (index < 0)
+        index += mUsedSegmentLength;
+    
+    // fast path when the whole kernel is inside the segment
+    if (index >= mTapsBefore && index + mTapsAfter < mUsedSegmentLength)
+        return interpolate(data + index, readPosFrac, band);
+    
+    // otherwise gather the kernel across the wrap point
+    std::array<SampleType, mSincMaxTaps> taps;
+    
+    for (int tap = -mTapsBefore; tap <= mTapsAfter; ++tap)
+    {
+        int tapIndex = (index + tap) % mUsedSegmentLength;
+        if (tapIndex < 0)
+            tapIndex += mUsedSegmentLength;
+        
+        taps[static_cast<size_t>(tap + mTapsBefore)] = data[tapIndex];
+    }
+    
+    return interpolate(taps.data() + mTapsBefore, readPosFrac, band);
+}
+
+template <typename SampleType>
+void CircularBuffer<SampleType>::interpolateContiguous(const SampleType* data, SampleType startPosition, SampleType rate, int numSamples, int band, SampleType* dest) const
+{
+    int sample = 0;
+    
+   #if JUCE_USE_SSE_INTRINSICS
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        const __m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        const __m128 rates = _mm_set1_ps(rate);
+        alignas(16) int indices[4];
+        alignas(16) float fracs[4];
+        
+        for (; sample + 4 <= numSamples; sample += 4)
+        {
+            const __m128 steps = _mm_add_ps(_mm_set1_ps(static_cast<float>(sample)), laneOffsets);
+            const __m128 position = _mm_add_ps(_mm_set1_ps(startPosition), _mm_mul_ps(steps, rates));
+            const __m128i index = _mm_cvttps_epi32(position);
+            
+            _mm_store_si128(reinterpret_cast<__m128i*>(indices), index);
+            _mm_store_ps(fracs, _mm_sub_ps(position, _mm_cvtepi32_ps(index)));
+            
+            interpolateLanes(data, indices, fracs, band, dest + sample);
+        }
+    }
+   #endif
+    
+    for (; sample < numSamples; ++sample)
+    {
+        const SampleType position = startPosition + static_cast<SampleType>(sample) * rate;
+        const int index = static_cast<int>(position);
+        
+        dest[sample] = interpolate(data + index, position - static_cast<SampleType>(index), band);
+    }
 }
 
 //==============================================================================
@@ -11,6 +11,9 @@
 
 #include <JuceHeader.h>
 
+// playback interpolation, cheapest first
+enum class interpolationQuality { kLinear, kHermite, kLagrange, kSinc };
+
 template <typename SampleType>
 class CircularBuffer
 {
@@ -29,7 +32,20 @@ public:
     void fillNextBlock(int channel, const int inBufferLength, const SampleType* inBufferData);
     
     //==============================================================================
-    const SampleType readSample(int channel, SampleType readPosition);
+    // rate only picks the sinc tier's anti-aliasing band
+    const SampleType readSample(int channel, SampleType readPosition, SampleType rate = 1) const;
+    
+    // reads numSamples at startPosition + n * rate, splitting at the wrap point;
+    // returns the (unwrapped) position after the last sample read
+    SampleType readBlock(int channel, SampleType startPosition, SampleType rate, int numSamples, SampleType* dest) const;
+    
+    // reads at each of numSamples non-negative positions
+    void readBlock(int channel, const SampleType* positions, int numSamples, SampleType* dest) const;
+    
+    //==============================================================================
+    void setInterpolationQuality(interpolationQuality newQuality);
+    
+    interpolationQuality getInterpolationQuality() const;
     
     //==============================================================================
     const int getBufferSize();
@@ -40,6 +56,35 @@ public:
     //==============================================================================
     void setUsedBufferSegmentLength(const int newSegmentLength);
 private:
+    void buildSincTable();
+    
+    int getSincBand(SampleType rate) const;
+    
+    // taps must hold every sample from -mTapsBefore to +mTapsAfter around the read index
+    SampleType interpolate(const SampleType* taps, SampleType frac, int band) const;
+    
+    SampleType interpolateSinc(const SampleType* taps, SampleType frac, int band) const;
+    
+    // four reads whose taps all lie inside the segment
+    void interpolateLanes(const SampleType* data, const int* indices, const SampleType* fracs, int band, SampleType* dest) const;
+    
+    SampleType interpolateWrapped(const SampleType* data, SampleType readPosition, int band) const;
+    
+    void interpolateContiguous(const SampleType* data, SampleType startPosition, SampleType rate, int numSamples, int band, SampleType* dest) const;
+    
+    // windowed-sinc polyphase bank: one band per maximum playback rate, each
+    // row is a phase (with a guard row for phase interpolation) of mSincMaxTaps
+    static constexpr int mSincPhases { 128 };
+    static constexpr int mSincMaxTaps { 64 };
+    static constexpr std::array<int, 3> mSincBandTaps { 32, 48, 64 };
+    static constexpr std::array<double, 3> mSincBandRates { 1.0, 1.5, 2.0 };
+    std::vector<SampleType> mSincTable;
+    
+    interpolationQuality mInterpolation { interpolationQuality::kLinear };
+    int mTapsBefore { 0 };
+    int mTapsAfter { 1 };
+    
+
     juce::AudioBuffer<SampleType> mCircularBuffer;
     
     std::vector<int> mWritePosition { 0, 0 };
@@ -48,7 +93,4 @@ private:
     int mNumSamples { 0 };
     int mTotalSize { 0 };
     int mUsedSegmentLength { 66150 };
-    
-    SampleType mReadPosFrac { 0 };
-    int mReadPosInt { 0 };
 };
@@ -6,7 +6,9 @@
  - Tanh Saturation
  Codec:
  - MuLaw
+ - ALaw
  - GSM 06.10
+ - IMA ADPCM
  Removed:
  - Chebyshev Drive
  - Downsample and Filter
@@ -23,37 +25,55 @@ Bitcrusher::~Bitcrusher() = default;
 void Bitcrusher::prepare(const juce::dsp::ProcessSpec& spec)
 {
     mSampleRate = spec.sampleRate;
+    
+    mHoldCounter.assign(spec.numChannels, 0);
+    mHeldSample.assign(spec.numChannels, 0.0f);
+    
     reset();
 }
 
 void Bitcrusher::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     int numSamples = buffer.getNumSamples();
-    int numChannels = buffer.getNumChannels();
+    int numChannels = std::min(buffer.getNumChannels(), static_cast<int>(mHoldCounter.size()));
     
     for (int channel = 0; channel < numChannels; ++channel)
     {
         auto* channelData = buffer.getWritePointer(channel);
         
-        for (int sample = 0; sample < numSamples; ++sample)
+        if (mParameters.downsampling <= 1)
         {
-            // reduce bit depth
-            float totalQLevels = powf(2.0f, mParameters.bitDepth);
-            float val = channelData[sample];
-            float remainder = fmodf(val, 1.0f/totalQLevels);
-            
-            // quantize
-            channelData[sample] = val - remainder;
-            
-            if (mParameters.downsampling > 1)
+            quantize(channelData, numSamples);
+            continue;
+        }
+        
+        // sample and hold, picking up where the last block left off: only the
+        // sample that starts each hold is quantized, the rest is a fill
+        auto& counter = mHoldCounter[channel];
+        auto& held = mHeldSample[channel];
+        
+        for (int sample = 0; sample < numSamples;)
+        {
+            if (counter == 0)
             {
-                if (sample % mParameters.downsampling != 0) channelData[sample] = channelData[sample - (sample % mParameters.downsampling)];
+                held = channelData[sample];
+                quantize(&held, 1);
             }
+            
+            const int run = std::min(mParameters.downsampling - counter, numSamples - sample);
+            juce::FloatVectorOperations::fill(channelData + sample, held, run);
+            
+            sample += run;
+            counter = (counter + run) % mParameters.downsampling;
         }
     }
 }
 
-void Bitcrusher::reset() {}
+void Bitcrusher::reset()
+{
+    std::fill(mHoldCounter.begin(), mHoldCounter.end(), 0);
+    std::fill(mHeldSample.begin(), mHeldSample.end(), 0.0f);
+}
 
 LofiProcessorParameters& Bitcrusher::getParameters() { return mParameters; }
 
@@ -62,11 +82,41 @@ void Bitcrusher::setParameters(const LofiProcessorParameters& params)
     if (mParameters.bitDepth != params.bitDepth || mParameters.downsampling != params.downsampling)
     {
         mParameters = params;
+        mParameters.downsampling = std::max(1, mParameters.downsampling);
+        
+        // the step only depends on the bit depth, so it is worked out here rather than per sample;
+        // 24 bits is already finer than the float mantissa near full scale
+        mQuantizeLevels = std::ldexp(1.0f, std::clamp(mParameters.bitDepth, 0, 24));
+        mQuantizeStep = 1.0f / mQuantizeLevels;
+        
+        for (auto& counter : mHoldCounter)
+            if (counter >= mParameters.downsampling)
+                counter = 0;
+    }
+}
+
+// truncates towards zero onto the step grid - the same result as x - fmodf(x, step)
+void Bitcrusher::quantize(float* data, int numSamples) const
+{
+    int sample = 0;
+    
+   #if JUCE_USE_SSE_INTRINSICS
+    const __m128 levels = _mm_set1_ps(mQuantizeLevels);
+    const __m128 step = _mm_set1_ps(mQuantizeStep);
+    
+    for (; sample + 4 <= numSamples; sample += 4)
+    {
+        const __m128i truncated = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(data + sample), levels));
+        _mm_storeu_ps(data + sample, _mm_mul_ps(_mm_cvtepi32_ps(truncated), step));
     }
+   #endif
+    
+    for (; sample < numSamples; ++sample)
+        data[sample] = static_cast<float>(static_cast<int>(data[sample] * mQuantizeLevels)) * mQuantizeStep;
 }
 
 //==============================================================================
-SaturationProcessor::SaturationProcessor() : mLowCutFilter(juce::dsp::IIR::Coefficients<float>::makeHighPass(44100, 75.0f)) {}
+SaturationProcessor::SaturationProcessor() = default;
 
 SaturationProcessor::~SaturationProcessor() = default;
 
@@ -75,9 +125,18 @@ void SaturationProcessor::prepare(const juce::dsp::ProcessSpec& spec)
     mSampleRate = spec.sampleRate;
     mNumChannels = spec.numChannels;
     
-    mLowCutFilter.prepare(spec);
-//    *mLowCutFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(mSampleRate, 75.0f);
-    mLowCutFilter.reset();
+    juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> lowCut;
+    lowCut.add(juce::dsp::IIR::Coefficients<float>::makeHighPass(mSampleRate, 75.0f));
+    
+    mLowCutFilter.prepare(mNumChannels, static_cast<int>(spec.maximumBlockSize), 1);
+    mLowCutFilter.setCoefficients(lowCut);
+    
+    mPrevInput.assign(spec.numChannels, 0.0f);
+    mPrevIntegral.assign(spec.numChannels, 0.0f);
+    mIntegralScratch.resize(spec.maximumBlockSize);
+    
+    // built here rather than on first use by the audio thread
+    getTanhTable();
     
     reset();
 }
@@ -86,160 +145,415 @@ void SaturationProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::M
 {
     juce::ScopedNoDenormals noDenormals;
     int numSamples = buffer.getNumSamples();
-    int numChannels = buffer.getNumChannels();
-    
-    float saturationGainLin = pow(10.0f, mParameters.drive / 20.0f);
+    int numChannels = std::min(buffer.getNumChannels(), static_cast<int>(mPrevInput.size()));
     
-    juce::dsp::AudioBlock<float> block(buffer);
-    mLowCutFilter.process(juce::dsp::ProcessContextReplacing<float> (block));
+    mLowCutFilter.process(buffer.getArrayOfWritePointers(), numChannels, numSamples);
     
     // drive
     for (int channel = 0; channel < numChannels; ++channel)
     {
         auto* channelData = buffer.getWritePointer(channel);
         
-        for (int sample = 0; sample < numSamples; ++sample)
+        juce::FloatVectorOperations::multiply(channelData, mGain, numSamples);
+        
+        switch (mParameters.kernel)
         {
-            channelData[sample] = std::tanh(saturationGainLin * channelData[sample]);
-            channelData[sample] *= 0.5f;
+            case saturationKernel::kTanh: processChannel<saturationKernel::kTanh>(channel, channelData, numSamples); break;
+            case saturationKernel::kPade: processChannel<saturationKernel::kPade>(channel, channelData, numSamples); break;
+            case saturationKernel::kTable: processChannel<saturationKernel::kTable>(channel, channelData, numSamples); break;
         }
+        
+        juce::FloatVectorOperations::multiply(channelData, 0.5f, numSamples);
     }
 }
 
-void SaturationProcessor::reset() {}
+void SaturationProcessor::reset()
+{
+    mLowCutFilter.reset();
+    std::fill(mPrevInput.begin(), mPrevInput.end(), 0.0f);
+    std::fill(mPrevIntegral.begin(), mPrevIntegral.end(), antiderivative(mParameters.kernel, 0.0f));
+}
 
 LofiProcessorParameters& SaturationProcessor::getParameters() { return mParameters; }
 
 void SaturationProcessor::setParameters(const LofiProcessorParameters& params)
 {
-    if (mParameters.drive != params.drive)
+    const bool antiderivativeChanged = params.kernel != mParameters.kernel || (params.antiAliasing && ! mParameters.antiAliasing);
+    
+    if (mParameters.drive != params.drive || mParameters.kernel != params.kernel || mParameters.antiAliasing != params.antiAliasing)
     {
-        mParameters.drive = params.drive;
         mParameters = params;
+        mGain = std::pow(10.0f, mParameters.drive / 20.0f);
     }
+    
+    // the carried antiderivative has to match the kernel that continues from it
+    if (antiderivativeChanged)
+        for (size_t channel = 0; channel < mPrevInput.size(); ++channel)
+            mPrevIntegral[channel] = antiderivative(mParameters.kernel, mPrevInput[channel]);
 }
 
 float SaturationProcessor::softClip(float x)
 {
-    if (x > 3.0f)
-        return 1.0f;
-    else if (x < -3.0f)
-        return -1.0f;
-    else return x * (27.0 + x * x) / (27.0 + 9.0 * x * x);
+    x = std::clamp(x, -3.0f, 3.0f);
+    return x * (27.0f + x * x) / (27.0f + 9.0f * x * x);
 }
 
 //==============================================================================
-MuLawProcessor::MuLawProcessor() = default;
+#if JUCE_USE_SSE_INTRINSICS
+namespace
+{
+    // exp for x <= 0 (Cephes' expf: 2^n * a degree 6 polynomial)
+    inline __m128 expNegativeSSE(__m128 x)
+    {
+        x = _mm_max_ps(x, _mm_set1_ps(-87.0f));
+        
+        // n = floor(x / ln 2 + 0.5)
+        const __m128 fx = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)), _mm_set1_ps(0.5f));
+        __m128i n = _mm_cvttps_epi32(fx);
+        __m128 rounded = _mm_cvtepi32_ps(n);
+        const __m128 overshoot = _mm_cmpgt_ps(rounded, fx);
+        n = _mm_add_epi32(n, _mm_castps_si128(overshoot)); // -1 where truncation rounded up
+        rounded = _mm_sub_ps(rounded, _mm_and_ps(overshoot, _mm_set1_ps(1.0f)));
+        
+        x = _mm_sub_ps(x, _mm_mul_ps(rounded, _mm_set1_ps(0.693359375f)));
+        x = _mm_sub_ps(x, _mm_mul_ps(rounded, _mm_set1_ps(-2.12194440e-4f)));
+        
+        __m128 y = _mm_set1_ps(1.9875691500e-4f);
+        y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.3981999507e-3f));
+        y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(8.3334519073e-3f));
+        y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(4.1665795894e-2f));
+        y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6666665459e-1f));
+        y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(5.0000001201e-1f));
+        y = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(y, x), x), _mm_add_ps(x, _mm_set1_ps(1.0f)));
+        
+        const __m128i exponent = _mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23);
+        return _mm_mul_ps(y, _mm_castsi128_ps(exponent));
+    }
+    
+    // sign(x) * (1 - e) / (1 + e), e = exp(-2|x|); within 1e-7 of std::tanh
+    inline __m128 tanhSSE(__m128 x)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 sign = _mm_and_ps(x, signMask);
+        const __m128 magnitude = _mm_min_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(9.0f));
+        
+        const __m128 e = expNegativeSSE(_mm_mul_ps(magnitude, _mm_set1_ps(-2.0f)));
+        const __m128 one = _mm_set1_ps(1.0f);
+        
+        return _mm_or_ps(_mm_div_ps(_mm_sub_ps(one, e), _mm_add_ps(one, e)), sign);
+    }
+}
+#endif
 
-MuLawProcessor::~MuLawProcessor() = default;
+template <>
+float SaturationProcessor::shape<saturationKernel::kTanh>(float x) { return std::tanh(x); }
 
-void MuLawProcessor::prepare(const juce::dsp::ProcessSpec& spec)
+template <>
+float SaturationProcessor::shape<saturationKernel::kPade>(float x) { return softClip(x); }
+
+template <>
+float SaturationProcessor::shape<saturationKernel::kTable>(float x)
 {
-    mSampleRate = spec.sampleRate;
-    mNumChannels = spec.numChannels;
+    const auto& table = getTanhTable();
+    const float position = (std::clamp(x, -mTableRange, mTableRange) + mTableRange) * (mTableSize / (2.0f * mTableRange));
+    const int index = static_cast<int>(position);
+    const float frac = position - static_cast<float>(index);
     
-    mFilterCoefficientsArray = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod((mSampleRate / mParameters.downsampling) * 0.4, mSampleRate, mResamplingFilterOrder);
-        
-    mPreFilters.resize(mNumChannels);
-    mPostFilters.resize(mNumChannels);
+    return table.values[index] + frac * (table.values[index + 1] - table.values[index]);
+}
+
+// log(cosh(x)), written so large |x| neither overflows nor cancels
+template <>
+float SaturationProcessor::antiderivative<saturationKernel::kTanh>(float x)
+{
+    const float magnitude = std::abs(x);
+    return magnitude + std::log1p(std::exp(-2.0f * magnitude)) - 0.693147180559945f;
+}
+
+// x^2/18 + 4/3 ln(1 + x^2/3) inside the clip points, a straight line outside
+template <>
+float SaturationProcessor::antiderivative<saturationKernel::kPade>(float x)
+{
+    const float magnitude = std::abs(x);
+    if (magnitude > 3.0f)
+        return magnitude - 2.5f + 1.84839248f; // + 4/3 ln 4, to meet the curve at 3
+    
+    return magnitude * magnitude / 18.0f + (4.0f / 3.0f) * std::log1p(magnitude * magnitude / 3.0f);
+}
+
+template <>
+float SaturationProcessor::antiderivative<saturationKernel::kTable>(float x)
+{
+    const auto& table = getTanhTable();
+    const float step = 2.0f * mTableRange / mTableSize;
+    
+    if (x <= -mTableRange)
+        return table.integrals[0] - x - mTableRange;
+    if (x >= mTableRange)
+        return table.integrals[mTableSize] + x - mTableRange;
+    
+    const float position = (x + mTableRange) / step;
+    const int index = static_cast<int>(position);
+    const float frac = position - static_cast<float>(index);
+    const float value = table.values[index];
+    
+    return table.integrals[index] + step * frac * (value + 0.5f * frac * (table.values[index + 1] - value));
+}
+
+float SaturationProcessor::antiderivative(saturationKernel kernel, float x)
+{
+    switch (kernel)
+    {
+        case saturationKernel::kPade: return antiderivative<saturationKernel::kPade>(x);
+        case saturationKernel::kTable: return antiderivative<saturationKernel::kTable>(x);
+        case saturationKernel::kTanh: break;
+    }
+    
+    return antiderivative<saturationKernel::kTanh>(x);
+}
+
+template <saturationKernel kernel>
+void SaturationProcessor::shapeBlock(float* data, int numSamples)
+{
+    int sample = 0;
     
-    for (int channel = 0; channel < mNumChannels; ++channel)
+   #if JUCE_USE_SSE_INTRINSICS
+    if constexpr (kernel == saturationKernel::kTanh)
     {
-        mPreFilters[channel].resize(mResamplingFilterOrder / 2);
-        mPostFilters[channel].resize(mResamplingFilterOrder / 2);
+        for (; sample + 4 <= numSamples; sample += 4)
+            _mm_storeu_ps(data + sample, tanhSSE(_mm_loadu_ps(data + sample)));
+    }
+    else if constexpr (kernel == saturationKernel::kPade)
+    {
+        const __m128 limit = _mm_set1_ps(3.0f);
         
-        for (int filter = 0; filter < mResamplingFilterOrder / 2; ++filter)
+        for (; sample + 4 <= numSamples; sample += 4)
         {
-            mPreFilters[channel][filter].reset();
-            mPreFilters[channel][filter].prepare(spec);
-            mPreFilters[channel][filter].coefficients = mFilterCoefficientsArray.getObjectPointer(filter);
+            const __m128 x = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(data + sample), limit), _mm_sub_ps(_mm_setzero_ps(), limit));
+            const __m128 squared = _mm_mul_ps(x, x);
+            const __m128 numerator = _mm_mul_ps(x, _mm_add_ps(_mm_set1_ps(27.0f), squared));
+            const __m128 denominator = _mm_add_ps(_mm_set1_ps(27.0f), _mm_mul_ps(_mm_set1_ps(9.0f), squared));
+            _mm_storeu_ps(data + sample, _mm_div_ps(numerator, denominator));
+        }
+    }
+    else
+    {
+        const auto& values = getTanhTable().values;
+        const __m128 range = _mm_set1_ps(mTableRange);
+        const __m128 scale = _mm_set1_ps(mTableSize / (2.0f * mTableRange));
+        alignas(16) int indices[4];
+        
+        for (; sample + 4 <= numSamples; sample += 4)
+        {
+            const __m128 x = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(data + sample), range), _mm_sub_ps(_mm_setzero_ps(), range));
+            const __m128 position = _mm_mul_ps(_mm_add_ps(x, range), scale);
+            const __m128i index = _mm_cvttps_epi32(position);
+            const __m128 frac = _mm_sub_ps(position, _mm_cvtepi32_ps(index));
+            _mm_store_si128(reinterpret_cast<__m128i*>(indices), index);
             
-            mPostFilters[channel][filter].reset();
-            mPostFilters[channel][filter].prepare(spec);
-            mPostFilters[channel][filter].coefficients = mFilterCoefficientsArray.getObjectPointer(filter);
+            const __m128 y0 = _mm_setr_ps(values[indices[0]], values[indices[1]], values[indices[2]], values[indices[3]]);
+            const __m128 y1 = _mm_setr_ps(values[indices[0] + 1], values[indices[1] + 1], values[indices[2] + 1], values[indices[3] + 1]);
+            _mm_storeu_ps(data + sample, _mm_add_ps(y0, _mm_mul_ps(frac, _mm_sub_ps(y1, y0))));
         }
     }
+   #endif
     
-    reset();
+    for (; sample < numSamples; ++sample)
+        data[sample] = shape<kernel>(data[sample]);
 }
 
-void MuLawProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+// each output is the mean of the kernel between consecutive inputs,
+// (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1]), which attenuates the images the
+// kernel folds back; it costs half a sample of delay
+template <saturationKernel kernel>
+void SaturationProcessor::shapeBlockAntiAliased(int channel, float* data, int numSamples)
 {
-    int numSamples = buffer.getNumSamples();
-    int numChannels = buffer.getNumChannels();
+    float prevInput = mPrevInput[channel];
+    float prevIntegral = mPrevIntegral[channel];
     
-    for (int channel = 0; channel < numChannels; ++channel)
+    // chunks, in case the host sends more than it prepared us for
+    for (int start = 0; start < numSamples; start += static_cast<int>(mIntegralScratch.size()))
     {
-        auto* channelData = buffer.getWritePointer(channel);
+        const int chunk = std::min(numSamples - start, static_cast<int>(mIntegralScratch.size()));
+        auto* input = data + start;
+        auto* integrals = mIntegralScratch.data();
+        
+        for (int sample = 0; sample < chunk; ++sample)
+            integrals[sample] = antiderivative<kernel>(input[sample]);
         
-        for (int sample = 0; sample < numSamples; ++sample)
+        for (int sample = 0; sample < chunk; ++sample)
         {
-            // Mu-Law processing on channelData
-            int16_t pcm_in = static_cast<int16_t>(channelData[sample] * 32767.0);
-            uint8_t compressed = Lin2MuLaw(pcm_in);
+            const float x = input[sample];
+            const float delta = x - prevInput;
             
-            int16_t pcm_out = MuLaw2Lin(compressed);
-            channelData[sample] = static_cast<float>(pcm_out) * mOutScale;
+            // too close to resolve: the midpoint is then within ~1e-6 of the mean
+            const float tolerance = mAntiAliasingTolerance * std::max(1.0f, std::max(std::abs(x), std::abs(prevInput)));
             
-            // downsample and filter
-            if (mParameters.downsampling > 1)
-            {
-                // pre-filtering
-                for (int filter = 0; filter < mResamplingFilterOrder / 2; ++filter)
-                {
-                    channelData[sample] = mPreFilters[channel][filter].processSample(channelData[sample]);
-                    mPreFilters[channel][filter].snapToZero();
-                }
-                
-                // downsampling
-                if (mDownsamplingCounter[channel] == 0)
-                    mDownsamplingInput[channel] = channelData[sample];
-                
-                channelData[sample] = mDownsamplingInput[channel];
-                
-                ++mDownsamplingCounter[channel];
-                mDownsamplingCounter[channel] %= mParameters.downsampling;
-                
-                // post-filtering
-                for (int filter = 0; filter < mResamplingFilterOrder / 2; ++filter)
-                {
-                    channelData[sample] = mPostFilters[channel][filter].processSample(channelData[sample]);
-                    mPostFilters[channel][filter].snapToZero();
-                }
-                
-//                std::vector<float> downsamplingGainComp { 1.0f, 1.0f, 1.45f, 2.35f, 3.5f, 4.35f, 5.5f, 6.25f, 7.0f };
-//                channelData[sample] *= downsamplingGainComp[parameters.downsampling];
-            }
+            input[sample] = std::abs(delta) > tolerance ? (integrals[sample] - prevIntegral) / delta
+                                                        : shape<kernel>(0.5f * (x + prevInput));
+            
+            prevInput = x;
+            prevIntegral = integrals[sample];
         }
     }
+    
+    mPrevInput[channel] = prevInput;
+    mPrevIntegral[channel] = prevIntegral;
+}
+
+template <saturationKernel kernel>
+void SaturationProcessor::processChannel(int channel, float* data, int numSamples)
+{
+    if (mParameters.antiAliasing && ! mIntegralScratch.empty())
+    {
+        shapeBlockAntiAliased<kernel>(channel, data, numSamples);
+        return;
+    }
+    
+    // tracked even when off, so switching anti-aliasing on carries on from here
+    if (numSamples > 0)
+        mPrevInput[channel] = data[numSamples - 1];
+    
+    shapeBlock<kernel>(data, numSamples);
+}
+
+//==============================================================================
+SaturationProcessor::TanhTable::TanhTable()
+{
+    const double step = 2.0 * mTableRange / mTableSize;
+    double integral = 0.0;
+    
+    for (int point = 0; point <= mTableSize; ++point)
+    {
+        values[point] = static_cast<float>(std::tanh(-mTableRange + point * step));
+        
+        // exact integral of the interpolated table, trapezoid by trapezoid
+        if (point > 0)
+            integral += 0.5 * step * (static_cast<double>(values[point - 1]) + values[point]);
+        integrals[point] = static_cast<float>(integral);
+    }
+    
+    // centred on zero, where the values are small and most precise
+    const float centre = integrals[mTableSize / 2];
+    for (int point = 0; point <= mTableSize; ++point)
+        integrals[point] -= centre;
+    
+    // guard for reads at exactly +mTableRange
+    values[mTableSize + 1] = values[mTableSize];
+    integrals[mTableSize + 1] = integrals[mTableSize];
+}
+
+const SaturationProcessor::TanhTable& SaturationProcessor::getTanhTable()
+{
+    static const TanhTable table;
+    return table;
 }
 
-void MuLawProcessor::reset() {}
+//==============================================================================
+MuLawProcessor::MuLawProcessor() : MuLawProcessor(getMuLawTable()) {}
+
+MuLawProcessor::MuLawProcessor(const CompandingTable& table) : mTable(&table) {}
+
+MuLawProcessor::~MuLawProcessor() = default;
+
+void MuLawProcessor::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    mSampleRate = spec.sampleRate;
+    mNumChannels = spec.numChannels;
+    
+    mResampler.prepare(mNumChannels, static_cast<int>(spec.maximumBlockSize), spec.sampleRate);
+    mResampler.setFactor(mParameters.downsampling);
+    
+    reset();
+}
+
+void MuLawProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    int numSamples = buffer.getNumSamples();
+    int numChannels = std::min(buffer.getNumChannels(), mNumChannels);
+    auto* const* channels = buffer.getArrayOfWritePointers();
+    
+    // decimate, encode at the reduced rate, interpolate; the resampler passes
+    // straight through at 1, and runs both factors while switching between them
+    for (int start = 0; start < numSamples; start += mResampler.getMaximumBlockSize())
+    {
+        const int chunk = std::min(numSamples - start, mResampler.getMaximumBlockSize());
+        mResampler.decimate(channels, numChannels, start, chunk);
+        
+        for (int path = 0; path < mResampler.getNumActivePaths(); ++path)
+            for (int channel = 0; channel < numChannels; ++channel)
+                roundTrip(mResampler.getReducedChannel(channel, path), mResampler.getNumReduced(path));
+        
+        mResampler.interpolate(channels, numChannels, start, chunk);
+    }
+    
+//    std::vector<float> downsamplingGainComp { 1.0f, 1.0f, 1.45f, 2.35f, 3.5f, 4.35f, 5.5f, 6.25f, 7.0f };
+//    buffer.applyGain(downsamplingGainComp[parameters.downsampling]);
+}
+
+void MuLawProcessor::reset() { mResampler.reset(); }
 
 LofiProcessorParameters& MuLawProcessor::getParameters() { return mParameters; }
 
 void MuLawProcessor::setParameters(const LofiProcessorParameters& params)
 {
     if (mParameters.downsampling != params.downsampling)
+        mResampler.setFactor(params.downsampling);
+    
+    mParameters = params;
+}
+
+int MuLawProcessor::getLatencySamples() const { return mResampler.getLatency(); }
+
+template <typename Encode, typename Decode>
+MuLawProcessor::CompandingTable MuLawProcessor::makeCompandingTable(Encode encode, Decode decode)
+{
+    CompandingTable table;
+    
+    for (int pcm = -32768; pcm <= 32767; ++pcm)
+        table.values[static_cast<uint16_t>(pcm)] = decode(encode(static_cast<int16_t>(pcm)));
+    
+    return table;
+}
+
+const MuLawProcessor::CompandingTable& MuLawProcessor::getMuLawTable()
+{
+    static const CompandingTable table = makeCompandingTable(Lin2MuLaw, MuLaw2Lin);
+    return table;
+}
+
+void MuLawProcessor::roundTrip(float* data, int numSamples) const
+{
+    const auto& values = mTable->values;
+    int sample = 0;
+    
+    // inputs are clamped to the 16-bit range first, where the old int16_t cast wrapped
+   #if JUCE_USE_SSE_INTRINSICS
+    const __m128 inScale = _mm_set1_ps(32767.0f);
+    const __m128 outScale = _mm_set1_ps(mOutScale);
+    const __m128 lowest = _mm_set1_ps(-32768.0f);
+    const __m128 highest = _mm_set1_ps(32767.0f);
+    alignas(16) int32_t pcm[4];
+    
+    for (; sample + 4 <= numSamples; sample += 4)
     {
-        // coefficients
-        mFilterCoefficientsArray = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod((mSampleRate / params.downsampling) * 0.4, mSampleRate, mResamplingFilterOrder); 
+        const __m128 scaled = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(data + sample), inScale), lowest), highest);
+        _mm_store_si128(reinterpret_cast<__m128i*>(pcm), _mm_cvttps_epi32(scaled));
         
-        for (int channel = 0; channel < mNumChannels; ++channel)
-        {
-            for (int filter = 0; filter < mResamplingFilterOrder / 2; ++filter)
-            {
-                mPreFilters[channel][filter].coefficients = mFilterCoefficientsArray.getObjectPointer(filter);
-                
-                mPostFilters[channel][filter].coefficients = mFilterCoefficientsArray.getObjectPointer(filter);
-            }
-        }
+        const __m128i decoded = _mm_setr_epi32(values[static_cast<uint16_t>(pcm[0])], values[static_cast<uint16_t>(pcm[1])],
+                                               values[static_cast<uint16_t>(pcm[2])], values[static_cast<uint16_t>(pcm[3])]);
+        _mm_storeu_ps(data + sample, _mm_mul_ps(_mm_cvtepi32_ps(decoded), outScale));
     }
+   #endif
     
-    mParameters = params;
+    for (; sample < numSamples; ++sample)
+    {
+        const auto pcm = static_cast<int16_t>(std::clamp(data[sample] * 32767.0f, -32768.0f, 32767.0f));
+        data[sample] = static_cast<float>(values[static_cast<uint16_t>(pcm)]) * mOutScale;
+    }
 }
 
-inline unsigned char MuLawProcessor::Lin2MuLaw(int16_t pcm_val)
+unsigned char MuLawProcessor::Lin2MuLaw(int16_t pcm_val)
 {
     int sign = (pcm_val >> 8) & 0x80;
     if (sign)
@@ -254,11 +568,60 @@ inline unsigned char MuLawProcessor::Lin2MuLaw(int16_t pcm_val)
     return static_cast<unsigned char>(compressedByte);
 }
 
-inline short MuLawProcessor::MuLaw2Lin(uint8_t u_val)
+short MuLawProcessor::MuLaw2Lin(uint8_t u_val)
 {
     return MuLawDecompressTable[u_val];
 }
 
+//==============================================================================
+ALawProcessor::ALawProcessor() : MuLawProcessor(getALawTable()) {}
+
+ALawProcessor::~ALawProcessor() = default;
+
+const MuLawProcessor::CompandingTable& ALawProcessor::getALawTable()
+{
+    static const CompandingTable table = makeCompandingTable(Lin2ALaw, ALaw2Lin);
+    return table;
+}
+
+// after the G.711 reference (Sun Microsystems' g711.c)
+unsigned char ALawProcessor::Lin2ALaw(int16_t pcm_val)
+{
+    int magnitude = pcm_val >> 3;
+    int mask = 0xd5;
+    if (magnitude < 0)
+    {
+        mask = 0x55;
+        magnitude = -magnitude - 1;
+    }
+    
+    // segment ends at 0x1f, 0x3f, ... 0xfff
+    int segment = 0;
+    while (segment < 8 && magnitude > (0x20 << segment) - 1)
+        ++segment;
+    
+    if (segment >= 8)
+        return static_cast<unsigned char>(0x7f ^ mask);
+    
+    int compressedByte = (segment << 4) | ((magnitude >> (segment < 2 ? 1 : segment)) & 0x0f);
+    
+    return static_cast<unsigned char>(compressedByte ^ mask);
+}
+
+short ALawProcessor::ALaw2Lin(uint8_t a_val)
+{
+    a_val ^= 0x55;
+    
+    int magnitude = (a_val & 0x0f) << 4;
+    int segment = (a_val & 0x70) >> 4;
+    
+    magnitude += segment == 0 ? 8 : 0x108;
+    if (segment > 1)
+        magnitude <<= segment - 1;
+    
+    return static_cast<short>((a_val & 0x80) ? magnitude : -magnitude);
+}
+
 //==============================================================================
 GSMProcessor::GSMProcessor() = default;
 
@@ -267,23 +630,14 @@ GSMProcessor::~GSMProcessor() = default;
 void GSMProcessor::prepare(const juce::dsp::ProcessSpec& spec)
 {
     mSampleRate = spec.sampleRate;
+    mNumChannels = spec.numChannels;
+    mMaximumBlockSize = std::max(1, static_cast<int>(spec.maximumBlockSize));
+    mChannelStates.resize(mNumChannels);
+    mNumStages = mNumChannels * mStagesPerChannel;
     
-    mFilterCoefficientsArray = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod((mSampleRate / mParameters.downsampling) * 0.4, mSampleRate, mResamplingFilterOrder);
-    
-    mPreFilters.resize(mResamplingFilterOrder / 2);
-    mPostFilters.resize(mResamplingFilterOrder / 2);
-    
-    for (int filter = 0; filter < mResamplingFilterOrder / 2; ++filter)
-    {
-        // prepare each pre-filter
-        mPreFilters[filter].reset();
-        mPreFilters[filter].prepare(spec);
-        mPreFilters[filter].coefficients = mFilterCoefficientsArray.getObjectPointer(filter);
-        
-        mPostFilters[filter].reset();
-        mPostFilters[filter].prepare(spec);
-        mPostFilters[filter].coefficients = mFilterCoefficientsArray.getObjectPointer(filter);
-    }
+    mToCodecRate.prepare(mNumChannels, spec.sampleRate, mCodecRate, mMaximumBlockSize);
+    mCodecBuffer.setSize(mNumChannels, mToCodecRate.getMaximumOutputBlockSize());
+    mFromCodecRate.prepare(mNumChannels, mCodecRate, spec.sampleRate, mCodecBuffer.getNumSamples());
     
     reset();
 }
@@ -291,114 +645,315 @@ void GSMProcessor::prepare(const juce::dsp::ProcessSpec& spec)
 void GSMProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     int numSamples = buffer.getNumSamples();
-    int numChannels = buffer.getNumChannels();
+    int numChannels = std::min(buffer.getNumChannels(), mNumChannels);
+    auto* const* channels = buffer.getArrayOfWritePointers();
+    auto* const* codecChannels = mCodecBuffer.getArrayOfWritePointers();
     
-    juce::AudioBuffer<float> monoBuffer(1, numSamples);
-    monoBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
-    if (numChannels > 1)
+    // down to 8 kHz, through the codec, back up; the return trip always has
+    // enough 8 kHz samples to fill the block, as both share one timeline
+    for (int start = 0; start < numSamples; start += mMaximumBlockSize)
     {
-        monoBuffer.addFrom(0, 0, buffer, 1, 0, numSamples);
-        monoBuffer.applyGain(0.5f);
+        const int chunk = std::min(numSamples - start, mMaximumBlockSize);
+        
+        mToCodecRate.push(channels, numChannels, start, chunk);
+        const int numCodecSamples = mToCodecRate.pull(codecChannels, numChannels, 0, mCodecBuffer.getNumSamples());
+        
+        encodeDecode(numChannels, numCodecSamples);
+        
+        mFromCodecRate.push(codecChannels, numChannels, 0, numCodecSamples);
+        const int numOutput = mFromCodecRate.pull(channels, numChannels, start, chunk);
+        jassert(numOutput == chunk);
+        juce::ignoreUnused(numOutput);
     }
-    
-    auto* src = monoBuffer.getWritePointer(0);
-    
-    for (int sample = 0; sample < numSamples; ++sample)
+}
+
+// each sample goes into the frame being gathered and comes back out of the one
+// before it, so the codec adds exactly one frame (20 ms) of delay. Spreading
+// the load codes each frame while the next is gathered, a stage or so every
+// few samples instead of all at once, and plays it a frame later
+void GSMProcessor::encodeDecode(int numChannels, int numSamples)
+{
+    for (int start = 0; start < numSamples;)
     {
-        // if gsm data variables are valid, process audio
-        if (mGsmSignalInput != nullptr && mGsmSignal != nullptr && mGsmSignalOutput != nullptr)
+        const int run = std::min(mFrameSize - mFrameCounter, numSamples - start);
+        
+        for (int channel = 0; channel < numChannels; ++channel)
         {
-            // ================ pre-filtering block ================
-            // low cut filter
-//            src[sample] = mLowCutFilter.processSample(src[sample]);
-            
-            // pre-filter if downsampling
-            if (mParameters.downsampling > 1)
-            {
-                for (int filter = 0; filter < mResamplingFilterOrder / 2; ++filter)
-                {
-                    src[sample] = mPreFilters[filter].processSample(src[sample]);
-                    mPreFilters[filter].snapToZero();
-                }
-            }
-            
-            //================ GSM processing block ================
-            // sync data rate to downsampling counter
-            if (mDownsamplingCounter == 0)
-            {
-                mGsmSignalInput.get()[mGsmSignalCounter] = static_cast<gsm_signal>(src[sample] * 4096.0f);
-                
-                mGsmSignalInput.get()[mGsmSignalCounter] <<= 3;
-                mGsmSignalInput.get()[mGsmSignalCounter] &= 0b1111111111111000;
-                
-                ++mGsmSignalCounter;
-                mGsmSignalCounter %= 160;
-                
-                if (mGsmSignalCounter == 0)
-                {
-                    std::swap(mGsmSignalInput, mGsmSignal);
-                    gsm_encode(mEncode.get(), mGsmSignal.get(), mGsmFrame.get());
-                    gsm_decode(mDecode.get(), mGsmFrame.get(), mGsmSignal.get());
-                    std::swap(mGsmSignal, mGsmSignalOutput);
-                }
-                
-                mGsmSignalOutput.get()[mGsmSignalCounter] >>= 3;
-                // sample has moved from src -> gsm -> currentSample
-                mCurrentSample = static_cast<float>(mGsmSignalOutput.get()[mGsmSignalCounter]) / 4096.0f;
-            }
-            // return sample to src for filtering
-            src[sample] = mCurrentSample;
+            auto& codec = mChannelStates[static_cast<size_t>(channel)];
+            auto* data = mCodecBuffer.getWritePointer(channel) + start;
+            auto* input = codec.input.data() + mFrameCounter;
+            const auto* output = codec.output.data() + mFrameCounter;
             
-            // increment downsampling frame
-            ++mDownsamplingCounter;
-            mDownsamplingCounter %= mParameters.downsampling;
+            // 13-bit samples, left-aligned as the codec expects
+            for (int sample = 0; sample < run; ++sample)
+                input[sample] = static_cast<gsm_signal>((static_cast<gsm_signal>(data[sample] * 4096.0f) << 3) & 0b1111111111111000);
             
-            //================= post-filtering block =================
-            // post-filter and compensate if downsampling
-            if (mParameters.downsampling > 1)
-            {
-                // post-filtering
-                for (int filter = 0; filter < mResamplingFilterOrder / 2; ++filter)
-                {
-                    src[sample] = mPostFilters[filter].processSample(src[sample]);
-                    mPostFilters[filter].snapToZero();
-                }
-//                std::vector<float> downsamplingGainComp { 1.0f, 1.0f, 1.45f, 2.35f, 3.5f, 4.35f, 5.5f, 6.25f, 7.0f };
-//                src[sample] *= downsamplingGainComp[parameters.downsampling];
-            }
+            for (int sample = 0; sample < run; ++sample)
+                data[sample] = static_cast<float>(output[sample] >> 3) / 4096.0f;
+        }
+        
+        start += run;
+        mFrameCounter += run;
+        mNumCodedChannels = numChannels;
+        
+        // the last stage falls due as the frame fills, so nothing is left over
+        if (mParameters.spreadLoad)
+            while (mNextStage < mNumStages && (mNextStage + 1) * mFrameSize <= mFrameCounter * mNumStages)
+                runStage(mNextStage++);
+        
+        // every channel's frame fills on the same sample, so they are coded together
+        if (mFrameCounter == mFrameSize)
+        {
+            mFrameCounter = 0;
+            startFrame();
             
-            for (int channel = 0; channel < numChannels; ++channel)
+            // otherwise coded right away and played from the next frame on
+            if (! mParameters.spreadLoad)
             {
-                auto* dst = buffer.getWritePointer(channel);
-                // signals to output
-                dst[sample] = src[sample];
+                while (mNextStage < mNumStages)
+                    runStage(mNextStage++);
+                
+                for (auto& codec : mChannelStates)
+                    std::swap(codec.output, codec.decoded);
             }
         }
     }
 }
 
-void GSMProcessor::reset() {}
+void GSMProcessor::startFrame()
+{
+    // normally every stage has run by now
+    while (mNextStage < mNumStages)
+        runStage(mNextStage++);
+    
+    for (auto& codec : mChannelStates)
+    {
+        if (mParameters.spreadLoad)
+            std::swap(codec.output, codec.decoded);
+        
+        std::swap(codec.pending, codec.input);
+    }
+    
+    mNextStage = 0;
+}
+
+void GSMProcessor::runStage(int stage)
+{
+    const int channel = stage / mStagesPerChannel;
+    const int step = stage % mStagesPerChannel;
+    
+    if (channel >= mNumCodedChannels)
+        return;
+    
+    auto& codec = mChannelStates[static_cast<size_t>(channel)];
+    
+    // what gsm_encode() and gsm_decode() do, minus packing the frame into bytes
+    if (step == 0)
+    {
+        Gsm_Coder_Analysis(&codec.encode, codec.pending.data(), codec.residual.data(), codec.LARc.data());
+    }
+    else if (step <= mNumSubsegments)
+    {
+        const int k = step - 1;
+        Gsm_Coder_Subsegment(&codec.encode, codec.residual.data(), k, &codec.Nc[k], &codec.bc[k], &codec.Mc[k], &codec.xmaxc[k], codec.xMc.data() + 13 * k);
+    }
+    else if (step <= 2 * mNumSubsegments)
+    {
+        const int j = step - 1 - mNumSubsegments;
+        Gsm_Decoder_Subsegment(&codec.decode, j, codec.Nc[j], codec.bc[j], codec.Mc[j], codec.xmaxc[j], codec.xMc.data() + 13 * j, codec.excitation.data());
+    }
+    else
+    {
+        Gsm_Decoder_Synthesis(&codec.decode, codec.LARc.data(), codec.excitation.data(), codec.decoded.data());
+    }
+}
+
+// the codec starts again from silence, as gsm_create() leaves it
+void GSMProcessor::reset()
+{
+    ChannelState initialState;
+    initialState.encode.nrp = 40;
+    initialState.decode.nrp = 40;
+    
+    // same size, so this reuses the vector's storage
+    mChannelStates.assign(mChannelStates.size(), initialState);
+    mFrameCounter = 0;
+    mNextStage = mNumStages;
+    mNumCodedChannels = 0;
+    applyQuality();
+    
+    mToCodecRate.reset();
+    mFromCodecRate.reset();
+}
 
 LofiProcessorParameters& GSMProcessor::getParameters() { return mParameters; }
 
+// the downsampling setting doesn't apply - the codec always runs at its native 8 kHz
 void GSMProcessor::setParameters(const LofiProcessorParameters& params)
+{
+    const bool qualityChanged = params.quality != mParameters.quality;
+    const bool spreadChanged = params.spreadLoad != mParameters.spreadLoad;
+    mParameters = params;
+    
+    if (qualityChanged)
+        applyQuality();
+    
+    // the delay changes, so start the pipeline again rather than jump within it
+    if (spreadChanged)
+    {
+        for (auto& codec : mChannelStates)
+        {
+            codec.input.fill(0);
+            codec.pending.fill(0);
+            codec.decoded.fill(0);
+            codec.output.fill(0);
+        }
+        
+        mFrameCounter = 0;
+        mNextStage = mNumStages;
+    }
+}
+
+int GSMProcessor::getLatencySamples() const { return calculateLatency(mParameters.spreadLoad); }
+
+int GSMProcessor::getMaxLatencySamples() const { return calculateLatency(true); }
+
+int GSMProcessor::calculateLatency(bool spreadLoad) const
+{
+    const int frameDelay = mFrameSize * (spreadLoad ? 2 : 1);
+    const double codecRateDelay = mFromCodecRate.getLatency() + frameDelay;
+    
+    return juce::roundToInt(mToCodecRate.getLatency() + codecRateDelay * mSampleRate / mCodecRate);
+}
+
+// the state carries on; the next frame is simply coded the new way
+void GSMProcessor::applyQuality()
+{
+    int fast = mParameters.quality != gsmQuality::kExact ? 1 : 0;
+    int ltpCut = mParameters.quality == gsmQuality::kFastLtpCut ? 1 : 0;
+    
+    for (auto& codec : mChannelStates)
+    {
+        gsm_option(&codec.encode, GSM_OPT_FAST, &fast);
+        gsm_option(&codec.encode, GSM_OPT_LTP_CUT, &ltpCut);
+        gsm_option(&codec.decode, GSM_OPT_FAST, &fast);
+    }
+}
+
+//==============================================================================
+AdpcmProcessor::AdpcmProcessor() = default;
+
+AdpcmProcessor::~AdpcmProcessor() = default;
+
+void AdpcmProcessor::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    mSampleRate = spec.sampleRate;
+    mNumChannels = spec.numChannels;
+    
+    for (auto& states : mChannelStates)
+        states.resize(static_cast<size_t>(mNumChannels));
+    
+    mResampler.prepare(mNumChannels, static_cast<int>(spec.maximumBlockSize), spec.sampleRate);
+    mResampler.setFactor(mParameters.downsampling);
+    
+    reset();
+}
+
+void AdpcmProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    int numSamples = buffer.getNumSamples();
+    int numChannels = std::min(buffer.getNumChannels(), mNumChannels);
+    auto* const* channels = buffer.getArrayOfWritePointers();
+    
+    for (int start = 0; start < numSamples; start += mResampler.getMaximumBlockSize())
+    {
+        const int chunk = std::min(numSamples - start, mResampler.getMaximumBlockSize());
+        mResampler.decimate(channels, numChannels, start, chunk);
+        
+        for (int path = 0; path < mResampler.getNumActivePaths(); ++path)
+            for (int channel = 0; channel < numChannels; ++channel)
+                roundTrip(mChannelStates[static_cast<size_t>(path)][static_cast<size_t>(channel)],
+                          mResampler.getReducedChannel(channel, path),
+                          mResampler.getNumReduced(path));
+        
+        mResampler.interpolate(channels, numChannels, start, chunk);
+    }
+}
+
+void AdpcmProcessor::reset()
+{
+    mResampler.reset();
+    
+    for (auto& states : mChannelStates)
+        std::fill(states.begin(), states.end(), ChannelState {});
+}
+
+LofiProcessorParameters& AdpcmProcessor::getParameters() { return mParameters; }
+
+void AdpcmProcessor::setParameters(const LofiProcessorParameters& params)
 {
     if (mParameters.downsampling != params.downsampling)
     {
-        // coefficients
-        mFilterCoefficientsArray = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod((mSampleRate / params.downsampling) * 0.4, mSampleRate, mResamplingFilterOrder);
+        // the resampler moves the outgoing path to the second slot and starts
+        // the new one from silence, so the predictors follow suit
+        mResampler.setFactor(params.downsampling);
+        std::swap(mChannelStates[0], mChannelStates[1]);
+        std::fill(mChannelStates[0].begin(), mChannelStates[0].end(), ChannelState {});
+    }
+    
+    mParameters = params;
+}
+
+int AdpcmProcessor::getLatencySamples() const { return mResampler.getLatency(); }
+
+void AdpcmProcessor::roundTrip(ChannelState& state, float* data, int numSamples) noexcept
+{
+    int predictor = state.predictor;
+    int stepIndex = state.stepIndex;
+    
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const int pcm = static_cast<int>(std::clamp(data[sample] * 32767.0f, -32768.0f, 32767.0f));
+        int step = StepSizeTable[stepIndex];
+        
+        int difference = pcm - predictor;
+        const bool negative = difference < 0;
+        if (negative)
+            difference = -difference;
         
-        for (int filter = 0; filter < mResamplingFilterOrder / 2; ++filter)
+        // three magnitude bits, each halving the step; the decoder rebuilds
+        // the same difference from them
+        int code = 0;
+        int quantized = step >> 3;
+        
+        if (difference >= step)
         {
-            // update each pre-filter
-            mPreFilters[filter].coefficients = mFilterCoefficientsArray.getObjectPointer(filter);
-            
-            // update each post-filter
-            mPostFilters[filter].coefficients = mFilterCoefficientsArray.getObjectPointer(filter);
+            code = 4;
+            difference -= step;
+            quantized += step;
         }
+        step >>= 1;
+        if (difference >= step)
+        {
+            code |= 2;
+            difference -= step;
+            quantized += step;
+        }
+        step >>= 1;
+        if (difference >= step)
+        {
+            code |= 1;
+            quantized += step;
+        }
+        
+        predictor = std::clamp(negative ? predictor - quantized : predictor + quantized, -32768, 32767);
+        stepIndex = std::clamp(stepIndex + IndexTable[code], 0, 88);
+        
+        data[sample] = static_cast<float>(predictor) * (1.0f / 32767.0f);
     }
     
-    mParameters = params;
+    state.predictor = predictor;
+    state.stepIndex = stepIndex;
 }
 
 //==============================================================================
@@ -6,7 +6,9 @@
  - Tanh Saturation
  Codec:
  - MuLaw
+ - ALaw
  - GSM 06.10
+ - IMA ADPCM
  Removed:
  - Chebyshev Drive
  - Downsample and Filter
@@ -17,7 +19,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BiquadCascade.h"
 #include "Modulators.h"
+#include "PolyphaseResampler.h"
 #include "Utilities.h"
 
 // gsm files (in C)
@@ -32,6 +36,8 @@ extern "C" {
 class Bitcrusher : public LofiProcessorBase
 {
 public:
+    static constexpr const char* menuName { "Bitcrusher" };
+    
     Bitcrusher();
     
     ~Bitcrusher() override;
@@ -47,8 +53,18 @@ public:
     void setParameters(const LofiProcessorParameters& params) override;
     
 private:
+    void quantize(float* data, int numSamples) const;
+    
     LofiProcessorParameters mParameters;
     
+    // 2^bitDepth and its reciprocal
+    float mQuantizeLevels { 16777216.0f };
+    float mQuantizeStep { 1.0f / 16777216.0f };
+    
+    // per channel, so a hold can span a block boundary
+    std::vector<int> mHoldCounter;
+    std::vector<float> mHeldSample;
+    
     int mSampleRate = 44100;
 };
 
@@ -56,6 +72,8 @@ private:
 class SaturationProcessor : public LofiProcessorBase
 {
 public:
+    static constexpr const char* menuName { "Saturation" };
+    
     SaturationProcessor();
     
     ~SaturationProcessor() override;
@@ -74,16 +92,60 @@ private:
     int mNumChannels { 2 };
     
     LofiProcessorParameters mParameters;
+    float mGain { 1.0f };
+    
+    // the rational (Pade) kernel, clipped at +/-3 where it reaches +/-1
+    static float softClip(float x);
+    
+    template <saturationKernel kernel>
+    static float shape(float x);
+    
+    template <saturationKernel kernel>
+    static float antiderivative(float x);
+    
+    static float antiderivative(saturationKernel kernel, float x);
+    
+    // vectorized where the kernel allows it
+    template <saturationKernel kernel>
+    static void shapeBlock(float* data, int numSamples);
+    
+    // first-order antiderivative anti-aliasing
+    template <saturationKernel kernel>
+    void shapeBlockAntiAliased(int channel, float* data, int numSamples);
     
-    float softClip(float x);
+    template <saturationKernel kernel>
+    void processChannel(int channel, float* data, int numSamples);
     
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> mLowCutFilter;
+    // tanh over +/-mTableRange and its integral from 0, at mTableSize + 1 points (plus a guard);
+    // the integral is that of the linearly interpolated table, so the table's ADAA is exact
+    static constexpr int mTableSize { 4096 };
+    static constexpr float mTableRange { 8.0f };
+    struct TanhTable
+    {
+        TanhTable();
+        
+        std::array<float, mTableSize + 2> values;
+        std::array<float, mTableSize + 2> integrals;
+    };
+    static const TanhTable& getTanhTable();
+    
+    // relative input step below which the difference quotient is mostly rounding
+    static constexpr float mAntiAliasingTolerance { 1.0e-2f };
+    
+    // last input and its antiderivative per channel, carried across blocks
+    std::vector<float> mPrevInput;
+    std::vector<float> mPrevIntegral;
+    std::vector<float> mIntegralScratch;
+    
+    BiquadCascade mLowCutFilter;
 };
 
 //==============================================================================
 class MuLawProcessor : public LofiProcessorBase
 {
 public:
+    static constexpr const char* menuName { "Mu-Law" };
+    
     MuLawProcessor();
     
     ~MuLawProcessor() override;
@@ -98,13 +160,35 @@ public:
     
     void setParameters(const LofiProcessorParameters& params) override;
     
+    // the resampler's filters, the same at every downsampling factor
+    int getLatencySamples() const override;
+    
+protected:
+    // the whole encode/decode round trip for every 16-bit input, indexed by its bit pattern
+    struct CompandingTable
+    {
+        std::array<int16_t, 65536> values;
+    };
+    
+    template <typename Encode, typename Decode>
+    static CompandingTable makeCompandingTable(Encode encode, Decode decode);
+    
+    explicit MuLawProcessor(const CompandingTable& table);
+    
 private:
-    unsigned char Lin2MuLaw(int16_t pcm_val);
+    static const CompandingTable& getMuLawTable();
+    
+    // quantizes a block through mTable - no branches, vectorized apart from the lookup
+    void roundTrip(float* data, int numSamples) const;
+    
+    static unsigned char Lin2MuLaw(int16_t pcm_val);
+    
+    static short MuLaw2Lin(uint8_t u_val);
     
-    short MuLaw2Lin(uint8_t u_val);
+    static constexpr int mMuLawBias = 0x84;
+    static constexpr int mMuLawClip = 32635;
     
-    const int mMuLawBias = 0x84;
-    const int mMuLawClip = 32635;
+    const CompandingTable* mTable;
     
     constexpr static char MuLawCompressTable[256]
     {
@@ -166,23 +250,38 @@ private:
     
     int mSampleRate { 44100 };
     int mNumChannels { 2 };
-    int mResamplingFilterOrder { 8 };
-    std::vector<int> mDownsamplingCounter { 0, 0 };
-    std::vector<float> mDownsamplingInput { 0.0f, 0.0f };
     
     LofiProcessorParameters mParameters;
     
-    using IIR = juce::dsp::IIR::Filter<float>;
-    std::vector<std::vector<IIR>> mPreFilters;
-    std::vector<std::vector<IIR>> mPostFilters;
+    // the codec runs at the reduced rate, between decimation and interpolation
+    PolyphaseResampler mResampler;
+};
+
+//==============================================================================
+// G.711 A-law, through the same table and resampling as MuLawProcessor
+class ALawProcessor : public MuLawProcessor
+{
+public:
+    static constexpr const char* menuName { "A-Law" };
     
-    juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> mFilterCoefficientsArray;
+    ALawProcessor();
+    
+    ~ALawProcessor() override;
+    
+private:
+    static const CompandingTable& getALawTable();
+    
+    static unsigned char Lin2ALaw(int16_t pcm_val);
+    
+    static short ALaw2Lin(uint8_t a_val);
 };
 
 //==============================================================================
 class GSMProcessor : public LofiProcessorBase
 {
 public:
+    static constexpr const char* menuName { "GSM 06.10" };
+    
     GSMProcessor();
     
     ~GSMProcessor() override;
@@ -197,28 +296,132 @@ public:
     
     void setParameters(const LofiProcessorParameters& params) override;
     
+    // the resamplers' filters plus one frame, or two when the load is spread
+    int getLatencySamples() const override;
+    
+    // with the load spread
+    int getMaxLatencySamples() const override;
+    
 private:
-    std::unique_ptr<gsm_state> mEncode = std::make_unique<gsm_state>();
-    std::unique_ptr<gsm_state> mDecode = std::make_unique<gsm_state>();
-    std::unique_ptr<gsm_signal[]> mGsmSignalInput = std::make_unique<gsm_signal[]>(160);
-    std::unique_ptr<gsm_signal[]> mGsmSignal = std::make_unique<gsm_signal[]>(160);
-    std::unique_ptr<gsm_signal[]> mGsmSignalOutput = std::make_unique<gsm_signal[]>(160);
-    std::unique_ptr<gsm_byte[]> mGsmFrame = std::make_unique<gsm_byte[]>(33);
+    static constexpr int mFrameSize { 160 };
+    static constexpr int mNumSubsegments { 4 };
+    static constexpr double mCodecRate { 8000.0 };
+    
+    // per channel: the frame-wide analysis, the encoder's and decoder's
+    // sub-segments, then the frame-wide synthesis
+    static constexpr int mStagesPerChannel { 2 + 2 * mNumSubsegments };
+    
+    // one channel's codec: the frame being gathered, the one being coded and
+    // what it decodes to, and the one being played
+    struct ChannelState
+    {
+        gsm_state encode {};
+        gsm_state decode {};
+        std::array<gsm_signal, mFrameSize> input {};
+        std::array<gsm_signal, mFrameSize> pending {};
+        std::array<gsm_signal, mFrameSize> decoded {};
+        std::array<gsm_signal, mFrameSize> output {};
+        
+        // the coded frame, passed straight from encoder to decoder
+        std::array<word, mFrameSize> residual {};
+        std::array<word, 8> LARc {};
+        std::array<word, mNumSubsegments> Nc {}, bc {}, Mc {}, xmaxc {};
+        std::array<word, 13 * mNumSubsegments> xMc {};
+        std::array<word, mFrameSize> excitation {};
+    };
+    
+    // runs mCodecBuffer's first numSamples through the codec, in place
+    void encodeDecode(int numChannels, int numSamples);
+    
+    // one step of coding the pending frames; channel-major, mStagesPerChannel each
+    void runStage(int stage);
+    
+    // the gathered frame becomes the pending one, and the decoded one is played
+    void startFrame();
+    
+    // sets the library's options on every channel's encoder and decoder
+    void applyQuality();
+    
+    int calculateLatency(bool spreadLoad) const;
+    
+    std::vector<ChannelState> mChannelStates;
+    int mFrameCounter { 0 }; // samples gathered into the current frame
+    int mNextStage { 0 };
+    int mNumStages { 0 };
+    int mNumCodedChannels { 0 }; // of the pending frames
     
     LofiProcessorParameters mParameters;
     int mSampleRate { 44100 };
-    int mGsmSignalCounter { 0 };
-    int mDownsamplingCounter { 0 };
-    int mResamplingFilterOrder { 8 };
+    int mNumChannels { 2 };
+    int mMaximumBlockSize { 512 };
+    
+    // always at 8 kHz, whatever the host rate or downsampling setting, so it
+    // codes 50 frames a second
+    FixedRatioResampler mToCodecRate;
+    FixedRatioResampler mFromCodecRate;
+    juce::AudioBuffer<float> mCodecBuffer;
+};
+
+//==============================================================================
+// 4-bit IMA ADPCM, through the same resampling as MuLawProcessor. The decoder's
+// prediction is the encoder's own, so a round trip is just the encoder
+class AdpcmProcessor : public LofiProcessorBase
+{
+public:
+    static constexpr const char* menuName { "IMA ADPCM" };
+    
+    AdpcmProcessor();
+    
+    ~AdpcmProcessor() override;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec) override;
+    
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    
+    void reset() override;
+    
+    LofiProcessorParameters& getParameters() override;
+    
+    void setParameters(const LofiProcessorParameters& params) override;
+    
+    // the resampler's filters, the same at every downsampling factor
+    int getLatencySamples() const override;
+    
+private:
+    // one channel's predicted sample and step size index
+    struct ChannelState
+    {
+        int predictor { 0 };
+        int stepIndex { 0 };
+    };
+    
+    static void roundTrip(ChannelState& state, float* data, int numSamples) noexcept;
+    
+    constexpr static short StepSizeTable[89]
+    {
+            7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+           19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+           50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+          130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+          337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+          876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+         2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+         5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+    
+    // step index change for each code, ignoring its sign bit
+    constexpr static int IndexTable[8] { -1, -1, -1, -1, 2, 4, 6, 8 };
+    
+    int mSampleRate { 44100 };
+    int mNumChannels { 2 };
     
-    float mCurrentSample { 0.0f };
+    LofiProcessorParameters mParameters;
     
-    using IIR = juce::dsp::IIR::Filter<float>;
-    IIR mLowCutFilter;
-    std::vector<IIR> mPreFilters;
-    std::vector<IIR> mPostFilters;
+    // per resampler path, so the path fading out after a factor change keeps its own predictor
+    std::array<std::vector<ChannelState>, 2> mChannelStates;
     
-    juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> mFilterCoefficientsArray;
+    PolyphaseResampler mResampler;
 };
 
 //==============================================================================
@@ -11,7 +11,7 @@
 //================ LFO ================
 //==============================================================================
 template <typename SampleType>
-LFO<SampleType>::LFO() { srand(static_cast<uint32_t>(time(NULL))); }
+LFO<SampleType>::LFO() = default;
 
 template <typename SampleType>
 LFO<SampleType>::~LFO() = default;
@@ -160,7 +160,12 @@ template <typename SampleType>
 void Line<SampleType>::setParameters(const SampleType& newRampTime)
 {
     if (mRampTimeSamps != newRampTime)
+    {
+        if (mRampTimeSamps > 0)
+            mElapsedSamps *= newRampTime / mRampTimeSamps;
+        
         mRampTimeSamps = newRampTime;
+    }
     
     //rampTimeSamps = sampleRate * rampTimeSecs;
 }
@@ -172,30 +177,166 @@ void Line<SampleType>::setDestination(const SampleType& newDestination)
     {
         mDestinationValue = newDestination;
         mStartingValue = mOutput;
+        mElapsedSamps = 0.0;
+        mShape = mNextShape;
+        
+        if (mRampTimeSamps <= 0)
+            mOutput = mDestinationValue;
     }
-    
-    mPhaseInc = (mDestinationValue - mStartingValue) / mRampTimeSamps;
 }
 
+template <typename SampleType>
+void Line<SampleType>::setShape(rampShape newShape) { mNextShape = newShape; }
+
 template <typename SampleType>
 const SampleType Line<SampleType>::renderAudioOutput()
 {
-    if (mStartingValue < mDestinationValue)
+    if (getRemainingRampSamples() > 0)
     {
-        if (mOutput < mDestinationValue)
-            mOutput += mPhaseInc;
-        else
-            mOutput = mDestinationValue;
+        mElapsedSamps = std::min(mElapsedSamps + 1, mRampTimeSamps);
+        mOutput = getValueAt(mElapsedSamps);
     }
-    else
+    
+    return mOutput;
+}
+
+template <typename SampleType>
+int Line<SampleType>::renderBlock(SampleType* dest, int numSamples)
+{
+    const int numRamping = std::min(numSamples, getRemainingRampSamples());
+    
+    if (numRamping > 0)
     {
-        if (mOutput > mDestinationValue)
-            mOutput += mPhaseInc;
-        else
-            mOutput = mDestinationValue;
+        const SampleType range = mDestinationValue - mStartingValue;
+        const SampleType progressInc = 1 / mRampTimeSamps;
+        const SampleType firstProgress = mElapsedSamps * progressInc;
+        
+        // only the last output can overrun the ramp's time (when that isn't a whole number of samples)
+        const int numUnclamped = mElapsedSamps + numRamping < mRampTimeSamps ? numRamping : numRamping - 1;
+        
+        switch (mShape)
+        {
+            case rampShape::kLinear:
+                for (int i = 0; i < numUnclamped; ++i)
+                    dest[i] = mStartingValue + range * (firstProgress + static_cast<SampleType>(i + 1) * progressInc);
+                break;
+                
+            case rampShape::kSCurve:
+                for (int i = 0; i < numUnclamped; ++i)
+                {
+                    const SampleType progress = firstProgress + static_cast<SampleType>(i + 1) * progressInc;
+                    dest[i] = mStartingValue + range * progress * progress * (3 - 2 * progress);
+                }
+                break;
+                
+            case rampShape::kExponential:
+            {
+                // e^(-rate * progress), one multiply per sample
+                const SampleType decay = std::exp(-mExponentialRate * progressInc);
+                const SampleType scale = range / (1 - std::exp(-mExponentialRate));
+                SampleType remaining = std::exp(-mExponentialRate * firstProgress);
+                
+                for (int i = 0; i < numUnclamped; ++i)
+                {
+                    remaining *= decay;
+                    dest[i] = mStartingValue + scale * (1 - remaining);
+                }
+                break;
+            }
+        }
+        
+        mElapsedSamps = std::min(mElapsedSamps + static_cast<SampleType>(numRamping), mRampTimeSamps);
+        
+        if (numUnclamped < numRamping)
+            dest[numUnclamped] = getValueAt(mElapsedSamps);
+        
+        mOutput = dest[numRamping - 1];
     }
     
-    return mOutput;
+    std::fill(dest + numRamping, dest + numSamples, mOutput);
+    
+    return numRamping;
+}
+
+template <typename SampleType>
+int Line<SampleType>::getRemainingRampSamples() const
+{
+    if (mStartingValue == mDestinationValue || mElapsedSamps >= mRampTimeSamps)
+        return 0;
+    
+    return std::max(1, static_cast<int>(std::ceil(mRampTimeSamps - mElapsedSamps)));
+}
+
+template <typename SampleType>
+int Line<SampleType>::getSamplesUntilCrossing(SampleType threshold) const
+{
+    const SampleType range = mDestinationValue - mStartingValue;
+    
+    if ((threshold - mOutput) * range < 0 || (range == 0 && threshold == mOutput))
+        return 0;
+    
+    const SampleType fraction = (threshold - mStartingValue) / range;
+    if (getRemainingRampSamples() == 0 || fraction >= 1)
+        return std::numeric_limits<int>::max();
+    
+    // the first whole sample past the point where the shape reaches fraction
+    const SampleType crossing = unshapeFraction(mShape, fraction) * mRampTimeSamps - mElapsedSamps;
+    return std::max(1, static_cast<int>(std::floor(crossing)) + 1);
+}
+
+template <typename SampleType>
+void Line<SampleType>::skip(int numSamples)
+{
+    if (getRemainingRampSamples() > 0)
+    {
+        mElapsedSamps = std::min(mElapsedSamps + static_cast<SampleType>(numSamples), mRampTimeSamps);
+        mOutput = getValueAt(mElapsedSamps);
+    }
+}
+
+template <typename SampleType>
+SampleType Line<SampleType>::getCurrentValue() const { return mOutput; }
+
+template <typename SampleType>
+SampleType Line<SampleType>::getDestination() const { return mDestinationValue; }
+
+template <typename SampleType>
+SampleType Line<SampleType>::shapeProgress(rampShape shape, SampleType progress)
+{
+    switch (shape)
+    {
+        case rampShape::kExponential:
+            return (1 - std::exp(-mExponentialRate * progress)) / (1 - std::exp(-mExponentialRate));
+        case rampShape::kSCurve:
+            return progress * progress * (3 - 2 * progress);
+        case rampShape::kLinear:
+        default:
+            return progress;
+    }
+}
+
+template <typename SampleType>
+SampleType Line<SampleType>::unshapeFraction(rampShape shape, SampleType fraction)
+{
+    switch (shape)
+    {
+        case rampShape::kExponential:
+            return -std::log(1 - fraction * (1 - std::exp(-mExponentialRate))) / mExponentialRate;
+        case rampShape::kSCurve:
+            return 0.5 - std::sin(std::asin(1 - 2 * fraction) / 3);
+        case rampShape::kLinear:
+        default:
+            return fraction;
+    }
+}
+
+template <typename SampleType>
+SampleType Line<SampleType>::getValueAt(SampleType elapsed) const
+{
+    if (elapsed >= mRampTimeSamps)
+        return mDestinationValue;
+    
+    return mStartingValue + (mDestinationValue - mStartingValue) * shapeProgress(mShape, elapsed / mRampTimeSamps);
 }
 
 template class LFO<double>;
@@ -203,3 +344,90 @@ template class LFO<float>;
 
 template class Line<double>;
 template class Line<float>;
+
+//================ Wow & flutter ================
+//==============================================================================
+WowFlutter::WowFlutter() = default;
+
+void WowFlutter::prepare(double sampleRate, uint64_t seed)
+{
+    mSeed = seed;
+    
+    // the LFOs only step once per control interval
+    mControlRate = static_cast<float>(sampleRate / mControlInterval);
+    
+    OscillatorParameters params;
+    params.waveform = generatorWaveform::kSin;
+    
+    params.frequency_Hz = mWowFrequency;
+    mWow.setParameters(params);
+    
+    params.frequency_Hz = mFlutterFrequency;
+    mFlutter.setParameters(params);
+    
+    // a one-pole low-pass keeps c / (2 - c) of white noise's variance
+    mDriftCoefficient = static_cast<float>(1.0 - std::exp(-2.0 * M_PI * mDriftCutoff / mControlRate));
+    mDriftGain = std::sqrt((2.0f - mDriftCoefficient) / mDriftCoefficient);
+    
+    reset();
+}
+
+void WowFlutter::reset()
+{
+    mWow.reset(mControlRate);
+    mFlutter.reset(mControlRate);
+    mRandom.setSeed(mSeed);
+    
+    mDriftState = 0.0f;
+    mCurrent = 1.0f;
+    mTarget = 1.0f;
+    mIncrement = 0.0f;
+    mSamplesUntilUpdate = 0;
+}
+
+void WowFlutter::setDepth(float newDepth) { mDepth = std::clamp(newDepth, 0.0f, 1.0f); }
+
+bool WowFlutter::isActive() const { return mDepth > 0.0f || mCurrent != 1.0f || mTarget != 1.0f; }
+
+void WowFlutter::applyToBlock(float* rates, int numSamples)
+{
+    int sample = 0;
+    
+    while (sample < numSamples)
+    {
+        if (mSamplesUntilUpdate == 0)
+        {
+            mTarget = computeControlValue();
+            mIncrement = (mTarget - mCurrent) / static_cast<float>(mControlInterval);
+            mSamplesUntilUpdate = mControlInterval;
+        }
+        
+        const int runLength = std::min(numSamples - sample, mSamplesUntilUpdate);
+        
+        for (int i = 0; i < runLength; ++i)
+        {
+            mCurrent += mIncrement;
+            rates[sample + i] *= mCurrent;
+        }
+        
+        sample += runLength;
+        mSamplesUntilUpdate -= runLength;
+        
+        // lands exactly, so a depth of 0 settles at exactly 1
+        if (mSamplesUntilUpdate == 0)
+            mCurrent = mTarget;
+    }
+}
+
+float WowFlutter::computeControlValue()
+{
+    const float wow = mWow.renderAudioOutput().normalOutput;
+    const float flutter = mFlutter.renderAudioOutput().normalOutput;
+    
+    mDriftState += mDriftCoefficient * (2.0f * mRandom.nextFloat() - 1.0f - mDriftState);
+    
+    // the uniform noise's standard deviation is 1 / sqrt(3)
+    const float drift = mDriftState * mDriftGain * std::sqrt(3.0f);
+    
+    return 1.0f + mDepth * (mWowDepth * wow + mFlutterDepth * flutter + mDriftDepth * drift);
+}
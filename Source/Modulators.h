@@ -9,6 +9,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Utilities.h"
 
 // pure virtual base class
 /*
@@ -105,7 +106,7 @@ protected:
     inline void advanceModulo(SampleType& moduloCounter, SampleType phaseInc);
     
     const SampleType mB = 4.0 / M_PI;
-    const SampleType mC = -4.0 / (M_PI / M_PI);
+    const SampleType mC = -4.0 / (M_PI * M_PI);
     const SampleType mP = 0.225;
     
     inline SampleType parabolicSine(SampleType angle);
@@ -113,6 +114,10 @@ protected:
 
 //================ Line with start/end and ramp time ================
 //==============================================================================
+// how a Line moves from its start to its destination: at a constant rate, fast
+// at first then easing in (like a motor losing power), or easing in and out
+enum class rampShape { kLinear, kExponential, kSCurve };
+
 template <typename SampleType>
 class Line// : public IAudioSignalGenerator<SampleType>
 {
@@ -124,21 +129,115 @@ public:
     
     SampleType getParameters();
     
+    // a ramp already under way keeps its progress and finishes over the new time
     void setParameters(const SampleType& newRampTime);
     
     void setDestination(const SampleType& newDestination);
     
+    // used from the next setDestination() that moves the line
+    void setShape(rampShape newShape);
+    
     virtual const SampleType renderAudioOutput();
+    
+    // writes the next numSamples outputs, the same as calling renderAudioOutput()
+    // numSamples times, and returns how many of them are still on the ramp -
+    // the rest hold the destination
+    int renderBlock(SampleType* dest, int numSamples);
+    
+    // samples over which the output keeps moving; 0 once renderAudioOutput()
+    // would just return the destination
+    int getRemainingRampSamples() const;
+    
+    // outputs until the first one beyond threshold on the way to the destination:
+    // 0 if the output is already there, INT_MAX if the ramp never gets there
+    int getSamplesUntilCrossing(SampleType threshold) const;
+    
+    // same state as calling renderAudioOutput() numSamples times
+    void skip(int numSamples);
+    
+    SampleType getCurrentValue() const;
+    SampleType getDestination() const;
         
 private:
+    // how far from start to destination the ramp is after progress (0 to 1) of its time, and back
+    static SampleType shapeProgress(rampShape shape, SampleType progress);
+    static SampleType unshapeFraction(rampShape shape, SampleType fraction);
+    
+    SampleType getValueAt(SampleType elapsed) const;
+    
+    // kExponential covers all but e^-mExponentialRate of the distance in the first 1/mExponentialRate
+    // of its time, then is scaled to land exactly on the destination
+    static constexpr SampleType mExponentialRate = 5.0;
+    
     int mSampleRate = 44100;
     
-    SampleType mPhaseInc = 0.0;
     SampleType mRampTimeSecs = 0.15;
     SampleType mRampTimeSamps = 6615;
     
+    rampShape mShape = rampShape::kLinear;
+    rampShape mNextShape = rampShape::kLinear;
+    
     SampleType mStartingValue = 1.0;
     SampleType mDestinationValue = 1.0;
+    SampleType mElapsedSamps = 0.0; // into the current ramp, up to mRampTimeSamps
     
     SampleType mOutput = 1.0;
 };
+
+//================ Wow & flutter ================
+//==============================================================================
+// tape transport wobble: a slow LFO (wow), a fast one (flutter) and low-passed
+// noise (drift), worked out every mControlInterval samples and interpolated in
+// between, as a multiplier on the playback rate
+class WowFlutter
+{
+public:
+    WowFlutter();
+    
+    // the same seed gives the same wobble, so channels on one transport stay together
+    void prepare(double sampleRate, uint64_t seed);
+    
+    void reset();
+    
+    // 0 (off) to 1; reached over one control interval
+    void setDepth(float newDepth);
+    
+    // false once the depth is 0 and the output has settled back at 1
+    bool isActive() const;
+    
+    // multiplies numSamples playback rates by the wobble
+    void applyToBlock(float* rates, int numSamples);
+    
+private:
+    float computeControlValue();
+    
+    static constexpr int mControlInterval { 32 };
+    
+    static constexpr double mWowFrequency { 0.7 };
+    static constexpr double mFlutterFrequency { 7.5 };
+    static constexpr double mDriftCutoff { 1.5 };
+    
+    // rate deviation of each at full depth (drift's is its standard deviation)
+    static constexpr float mWowDepth { 0.012f };
+    static constexpr float mFlutterDepth { 0.003f };
+    static constexpr float mDriftDepth { 0.004f };
+    
+    float mControlRate { 44100.0f / mControlInterval };
+    
+    LFO<float> mWow;
+    LFO<float> mFlutter;
+    
+    RandomGenerator mRandom;
+    uint64_t mSeed { 0 };
+    
+    // one-pole low-pass on white noise, and the gain that brings it back to the noise's level
+    float mDriftCoefficient { 0.0f };
+    float mDriftGain { 1.0f };
+    float mDriftState { 0.0f };
+    
+    float mDepth { 0.0f };
+    float mCurrent { 1.0f };
+    float mTarget { 1.0f };
+    float mIncrement { 0.0f };
+    int mSamplesUntilUpdate { 0 };
+};
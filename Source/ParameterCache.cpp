@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    Parameter cache implementation
+
+  ==============================================================================
+*/
+
+#include "ParameterCache.h"
+
+//==============================================================================
+ParameterCache::ParameterCache(juce::AudioProcessorValueTreeState& parameters)
+{
+    for (int parameter = 0; parameter < mNumParameters; ++parameter)
+    {
+        mRawValues[parameter] = parameters.getRawParameterValue(mParameterIds[parameter]);
+        jassert(mRawValues[parameter] != nullptr);
+    }
+}
+
+//==============================================================================
+void ParameterCache::prepare(double sampleRate)
+{
+    for (auto& smoothedValue : mSmoothedFX)
+        smoothedValue.reset(sampleRate, mSmoothingTime);
+    
+    mFlagAll = true;
+}
+
+const ParameterSnapshot& ParameterCache::update(int numSamples)
+{
+    mChanged.reset();
+    
+    std::array<float, mNumParameters> rawValues;
+    
+    for (int parameter = 0; parameter < mNumParameters; ++parameter)
+    {
+        rawValues[parameter] = mRawValues[parameter]->load(std::memory_order_relaxed);
+        
+        if (mFlagAll || rawValues[parameter] != mLastRawValues[parameter])
+        {
+            mChanged.set(parameter);
+            mLastRawValues[parameter] = rawValues[parameter];
+        }
+    }
+    
+    //======== smoothed ========
+    // the FX amounts come first in pluginParameter
+    for (int fx = 0; fx < static_cast<int>(mSmoothedFX.size()); ++fx)
+    {
+        auto& smoothedValue = mSmoothedFX[fx];
+        
+        if (mFlagAll)
+            smoothedValue.setCurrentAndTargetValue(rawValues[fx]);
+        else if (mChanged[fx])
+            smoothedValue.setTargetValue(rawValues[fx]);
+        
+        // still flagged while gliding, since the value moves every block
+        if (smoothedValue.isSmoothing())
+        {
+            smoothedValue.skip(numSamples);
+            mChanged.set(fx);
+        }
+    }
+    
+    mFlagAll = false;
+    
+    //======== typed ========
+    const auto raw = [&rawValues](pluginParameter parameter) { return rawValues[static_cast<int>(parameter)]; };
+    
+    mSnapshot.analogFX = mSmoothedFX[0].getCurrentValue();
+    mSnapshot.digitalFX = mSmoothedFX[1].getCurrentValue();
+    mSnapshot.lofiFX = mSmoothedFX[2].getCurrentValue();
+    
+    mSnapshot.clockSpeed = raw(pluginParameter::kClockSpeed);
+    mSnapshot.clockSpeedNote = juce::roundToInt(raw(pluginParameter::kClockSpeedNote));
+    mSnapshot.bufferLength = raw(pluginParameter::kBufferLength);
+    mSnapshot.repeats = static_cast<int>(raw(pluginParameter::kRepeats));
+    mSnapshot.dryWetMix = raw(pluginParameter::kDryWetMix);
+    mSnapshot.clockMode = raw(pluginParameter::kClockMode) > 0.5f;
+    
+    mSnapshot.distType = juce::roundToInt(raw(pluginParameter::kDistType));
+    mSnapshot.codec = juce::roundToInt(raw(pluginParameter::kCodec));
+    mSnapshot.downsampling = juce::roundToInt(raw(pluginParameter::kDownsampling));
+    mSnapshot.interpolation = juce::roundToInt(raw(pluginParameter::kInterpolation));
+    mSnapshot.saturationKernel = juce::roundToInt(raw(pluginParameter::kSaturationKernel));
+    mSnapshot.gsmQuality = juce::roundToInt(raw(pluginParameter::kGsmQuality));
+    
+    mSnapshot.saturationAntiAliasing = raw(pluginParameter::kSaturationAntiAliasing) > 0.5f;
+    mSnapshot.gsmSpreadLoad = raw(pluginParameter::kGsmSpreadLoad) > 0.5f;
+    
+    return mSnapshot;
+}
+
+//==============================================================================
+bool ParameterCache::hasChanged(pluginParameter parameter) const { return mChanged[static_cast<size_t>(parameter)]; }
+
+const ParameterSnapshot& ParameterCache::getSnapshot() const { return mSnapshot; }
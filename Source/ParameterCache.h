@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    Parameter cache interface
+    - raw parameter values looked up once, read into a typed snapshot each
+      block with a flag for every value that changed since the last one
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <bitset>
+
+// every host parameter, in the order they are cached
+enum class pluginParameter { kAnalogFX, kDigitalFX, kLofiFX, kClockSpeed, kClockSpeedNote, kBufferLength, kRepeats, kDryWetMix, kClockMode, kDistType, kCodec, kDownsampling, kInterpolation, kSaturationKernel, kSaturationAntiAliasing, kGsmQuality, kGsmSpreadLoad, kNumParameters };
+
+struct ParameterSnapshot
+{
+    // smoothed
+    float analogFX { 0.0f };
+    float digitalFX { 0.0f };
+    float lofiFX { 0.0f };
+    
+    float clockSpeed { 825.0f }; // ms
+    int clockSpeedNote { 4 };
+    float bufferLength { 1000.0f }; // ms
+    int repeats { 1 };
+    float dryWetMix { 0.4f };
+    bool clockMode { false };
+    
+    // menu indices
+    int distType { 0 };
+    int codec { 0 };
+    int downsampling { 0 };
+    int interpolation { 0 };
+    int saturationKernel { 0 };
+    int gsmQuality { 0 };
+    
+    bool saturationAntiAliasing { false };
+    bool gsmSpreadLoad { false };
+};
+
+class ParameterCache
+{
+public:
+    explicit ParameterCache(juce::AudioProcessorValueTreeState& parameters);
+    
+    //==============================================================================
+    // sets the smoothing ramps and flags every value, so the first block after
+    // a prepare pushes everything
+    void prepare(double sampleRate);
+    
+    // one read of each parameter; smoothed values move on by numSamples
+    const ParameterSnapshot& update(int numSamples);
+    
+    //==============================================================================
+    bool hasChanged(pluginParameter parameter) const;
+    
+    const ParameterSnapshot& getSnapshot() const;
+
+private:
+    static constexpr int mNumParameters { static_cast<int>(pluginParameter::kNumParameters) };
+    static constexpr std::array<const char*, mNumParameters> mParameterIds { "analogFX", "digitalFX", "lofiFX", "clockSpeed", "clockSpeedNote", "bufferLength", "repeats", "dryWetMix", "clockMode", "distType", "codec", "downsampling", "interpolation", "saturationKernel", "saturationAntiAliasing", "gsmQuality", "gsmSpreadLoad" };
+    static constexpr double mSmoothingTime { 0.05 }; // seconds
+    
+    std::array<std::atomic<float>*, mNumParameters> mRawValues {};
+    std::array<float, mNumParameters> mLastRawValues {};
+    std::bitset<mNumParameters> mChanged;
+    bool mFlagAll { true };
+    
+    // the FX amounts, which glide to new settings
+    std::array<juce::SmoothedValue<float>, 3> mSmoothedFX;
+    
+    ParameterSnapshot mSnapshot;
+};
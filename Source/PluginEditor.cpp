@@ -117,17 +117,14 @@ RSBrokenMediaAudioProcessorEditor::RSBrokenMediaAudioProcessorEditor (RSBrokenMe
     
     // menus
     addAndMakeVisible(distMenu);
-    distMenu.addItem("Bitcrusher", 1);
-    distMenu.addItem("Saturation", 2);
+    distMenu.addItemList(DistortionRegistry::getMenuNames(), 1);
     distMenu.setSelectedId(1);
     distMenu.setTextWhenNothingSelected("Bitcrusher");
     distMenu.setJustificationType(juce::Justification::centred);
     distMenuAttachment.reset(new ComboBoxAttachment(valueTreeState, "distType", distMenu));
     
     addAndMakeVisible(codecModeMenu);
-    codecModeMenu.addItem("None", 1);
-    codecModeMenu.addItem("Mu-Law", 2);
-    codecModeMenu.addItem("GSM 06.10", 3);
+    codecModeMenu.addItemList(CodecRegistry::getMenuNames({ "None" }), 1);
     codecModeMenu.setSelectedId(1);
     codecModeMenu.setTextWhenNothingSelected("None");
     codecModeMenu.setJustificationType(juce::Justification::centred);
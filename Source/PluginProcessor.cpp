@@ -69,17 +69,36 @@ RSBrokenMediaAudioProcessor::RSBrokenMediaAudioProcessor()
                                                     false),
         std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { "distType", 1 },
                                                     "Dist Menu",
-                                                     juce::StringArray { "Bitcrush", "Saturation" },
+                                                     DistortionRegistry::getMenuNames(),
                                                     0),
         std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { "codec", 1 },
                                                     "Codec Menu",
-                                                     juce::StringArray { "None", "MuLaw", "GSM" },
+                                                     CodecRegistry::getMenuNames({ "None" }),
                                                     0),
         std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { "downsampling", 1 },
                                                     "Downsampling Menu",
                                                      juce::StringArray { "None", "x2", "x3", "x4", "x5", "x6", "x7", "x8" },
-                                                    0)
-}) {}
+                                                    0),
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { "interpolation", 1 },
+                                                    "Interpolation",
+                                                     juce::StringArray { "Eco (Linear)", "Hermite", "Lagrange", "High (Sinc)" },
+                                                    0),
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { "saturationKernel", 1 },
+                                                    "Saturation Shape",
+                                                     juce::StringArray { "Exact (tanh)", "Rational", "Table" },
+                                                    0),
+        std::make_unique<juce::AudioParameterBool>(juce::ParameterID { "saturationAntiAliasing", 1 },
+                                                    "Saturation Anti-Aliasing",
+                                                    false),
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { "gsmQuality", 1 },
+                                                    "GSM Quality",
+                                                     juce::StringArray { "Exact", "Fast", "Fastest (LTP Cut)" },
+                                                    0),
+        std::make_unique<juce::AudioParameterBool>(juce::ParameterID { "gsmSpreadLoad", 1 },
+                                                    "GSM Spread CPU Load",
+                                                    false)
+}),
+    parameterCache(parameters) {}
 
 RSBrokenMediaAudioProcessor::~RSBrokenMediaAudioProcessor() {}
 
@@ -158,6 +177,17 @@ void RSBrokenMediaAudioProcessor::prepareToPlay (double sampleRate, int samplesP
     spec.numChannels = getTotalNumInputChannels();
     
     dryWetMixer.prepare(spec);
+    
+    codecs.prepare(spec);
+    
+    // every codec, and "None", is padded to the slowest one's delay at this rate,
+    // so switching never moves the dry signal or the host's compensation
+    const int latency = codecs.getLatencySamples();
+    dryWetMixer.setWetLatency(static_cast<float>(latency));
+    setLatencySamples(latency);
+    
+    // everything was just rebuilt, so the first block pushes every parameter
+    parameterCache.prepare(sampleRate);
 }
 
 void RSBrokenMediaAudioProcessor::releaseResources()
@@ -196,6 +226,7 @@ void RSBrokenMediaAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer
 {
     //======== buffer safety ========
     juce::ScopedNoDenormals noDenormals;
+    ScopedAudioThreadAllocationCheck allocationCheck;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
     
@@ -204,90 +235,119 @@ void RSBrokenMediaAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer
     
     //======== tempo ========
     audioPlayHead = this->getPlayHead();
-    lastPosInfo.set(audioPlayHead->getPosition().orFallback(juce::AudioPlayHead::PositionInfo {}));
-    double quarterNotes = lastPosInfo.get().getPpqPosition().orFallback(0.0);
-    std::vector<float> clockNoteValues { 16.0f, 8.0f, 4.0f, 3.0f, 2.0f, 1.5f, 1.0f, 0.75f, 0.5f, 0.25f };
-    
-    //======== get parameters ========
-    float analogFX = parameters.getRawParameterValue("analogFX")->load();
+    juce::AudioPlayHead::PositionInfo posInfo;
+    if (audioPlayHead != nullptr)
+        posInfo = audioPlayHead->getPosition().orFallback(juce::AudioPlayHead::PositionInfo {});
     
-    float digitalFX = parameters.getRawParameterValue("digitalFX")->load();
+    // published for other threads; this thread keeps using its own copy
+    lastPosInfo.set(posInfo);
     
-    float lofiFX = parameters.getRawParameterValue("lofiFX")->load();
-    
-    float clockSpeed = parameters.getRawParameterValue("clockSpeed")->load() * (getSampleRate() / 1000);
-    
-    int clockSpeedNoteIndex = static_cast<juce::AudioParameterChoice*>(parameters.getParameter("clockSpeedNote"))->getIndex();
+    //======== get parameters ========
+    // setters below only run for values that moved, so loop points and clock
+    // state are not reset every block
+    const auto& params = parameterCache.update(buffer.getNumSamples());
     
-    int bufferLength = static_cast<int>(parameters.getRawParameterValue("bufferLength")->load() * 44.1f); // check menu data type
+    float clockSpeed = params.clockSpeed * (getSampleRate() / 1000);
     
-    int numRepeats = static_cast<int>(parameters.getRawParameterValue("repeats")->load()); // check menu data type
+    int bufferLength = static_cast<int>(params.bufferLength * 44.1f); // check menu data type
     
-    float dryWetMix = parameters.getRawParameterValue("dryWetMix")->load();
+    // follow the saved state as well as the editor's button
+    useDawClock = params.clockMode;
     
     // ======== mix in dry ========
-    dryWetMixer.setWetMixProportion(dryWetMix);
+    // the mixer ramps to a new proportion sample by sample
+    if (parameterCache.hasChanged(pluginParameter::kDryWetMix))
+        dryWetMixer.setWetMixProportion(params.dryWetMix);
+    
     dryWetMixer.pushDrySamples(juce::dsp::AudioBlock<float> { buffer });
     
     //======== constant codec processing ========
-    slotCodec = static_cast<juce::AudioParameterChoice*>(parameters.getParameter("codec"))->getIndex();
+    // crossfades from the running codec, which keeps going until it is faded out;
+    // a change during a crossfade is taken up once that one has finished
+    const bool codecChanged = codecs.select(params.codec);
     
-    if (slotCodec != prevSlotCodec)
+    if (auto* codecParameters = codecs.getParameters(codecs.getSelected()))
     {
-        slotProcessor = processorFactory.create(slotCodec);
-        
-        if (slotProcessor != nullptr)
+        if (codecChanged || parameterCache.hasChanged(pluginParameter::kDownsampling) || parameterCache.hasChanged(pluginParameter::kGsmQuality)
+            || parameterCache.hasChanged(pluginParameter::kGsmSpreadLoad))
         {
-            juce::dsp::ProcessSpec spec;
-            spec.sampleRate = getSampleRate();
-            spec.maximumBlockSize = buffer.getNumSamples();
-            spec.numChannels = buffer.getNumChannels();
+            processorParameters = *codecParameters;
+            
+            processorParameters.downsampling = params.downsampling + 1;
+            processorParameters.quality = static_cast<gsmQuality>(params.gsmQuality);
+            processorParameters.spreadLoad = params.gsmSpreadLoad;
             
-            slotProcessor->prepare(spec);
+            codecs.setParameters(codecs.getSelected(), processorParameters);
         }
-        
-        prevSlotCodec = slotCodec;
     }
     
-    if (slotProcessor != nullptr)
-    {
-        processorParameters = slotProcessor->getParameters();
-        
-        processorParameters.downsampling = static_cast<juce::AudioParameterChoice*>(parameters.getParameter("downsampling"))->getIndex() + 1;
-        
-        slotProcessor->setParameters(processorParameters);
-        
-        slotProcessor->processBlock(buffer, midiMessages);
-    }
+    codecs.process(buffer, midiMessages);
     
     //======== broken player ========
-    brokenPlayer.setAnalogFX(analogFX);
-    brokenPlayer.setDigitalFX(digitalFX);
-    brokenPlayer.setLofiFX(lofiFX);
+    if (parameterCache.hasChanged(pluginParameter::kAnalogFX))
+        brokenPlayer.setAnalogFX(params.analogFX);
+    if (parameterCache.hasChanged(pluginParameter::kDigitalFX))
+        brokenPlayer.setDigitalFX(params.digitalFX);
+    if (parameterCache.hasChanged(pluginParameter::kLofiFX))
+        brokenPlayer.setLofiFX(params.lofiFX);
+    
+    if (parameterCache.hasChanged(pluginParameter::kDistType))
+        brokenPlayer.setDistortionType(params.distType);
+    
+    if (parameterCache.hasChanged(pluginParameter::kInterpolation))
+        brokenPlayer.setInterpolationQuality(static_cast<interpolationQuality>(params.interpolation));
     
-    brokenPlayer.setDistortionType(static_cast<juce::AudioParameterChoice*>(parameters.getParameter("distType"))->getIndex());
+    if (parameterCache.hasChanged(pluginParameter::kSaturationKernel) || parameterCache.hasChanged(pluginParameter::kSaturationAntiAliasing))
+        brokenPlayer.setSaturationQuality(static_cast<saturationKernel>(params.saturationKernel), params.saturationAntiAliasing);
     
     brokenPlayer.useExternalClock(useDawClock);
     if (useDawClock == true)
-    {
-        float currentClock = floor(quarterNotes / clockNoteValues.at(clockSpeedNoteIndex));
-        if (lastClock != currentClock)
-        {
-            brokenPlayer.receiveClockedPulse();
-            lastClock = currentClock;
-        }
-    }
-    else
+        scheduleDawClockPulses(posInfo, clockNoteValues.at(params.clockSpeedNote), buffer.getNumSamples());
+    else if (parameterCache.hasChanged(pluginParameter::kClockSpeed) || parameterCache.hasChanged(pluginParameter::kClockMode))
         brokenPlayer.setClockSpeed(clockSpeed);
     
-    brokenPlayer.setBufferLength(bufferLength);
-    brokenPlayer.newNumRepeats(numRepeats);
+    if (parameterCache.hasChanged(pluginParameter::kBufferLength))
+        brokenPlayer.setBufferLength(bufferLength);
+    if (parameterCache.hasChanged(pluginParameter::kRepeats))
+        brokenPlayer.newNumRepeats(params.repeats);
+    
     brokenPlayer.processBlock(buffer, midiMessages);
     
     //======== mix in wet ========
     dryWetMixer.mixWetSamples(juce::dsp::AudioBlock<float> {buffer});
 }
 
+// each grid line goes to the sample nearest to it. While the transport runs, the
+// position moves on at the tempo through the block; otherwise only the block's start counts
+void RSBrokenMediaAudioProcessor::scheduleDawClockPulses(const juce::AudioPlayHead::PositionInfo& posInfo, double gridQuarterNotes, int numSamples)
+{
+    const double quarterNotes = posInfo.getPpqPosition().orFallback(0.0);
+    const double bpm = posInfo.getBpm().orFallback(0.0);
+    const double quarterNotesPerSample = posInfo.getIsPlaying() && bpm > 0.0 ? bpm / (60.0 * getSampleRate()) : 0.0;
+    
+    // a line within half a sample ahead belongs to this block's first sample
+    double currentClock = std::floor((quarterNotes + 0.5 * quarterNotesPerSample) / gridQuarterNotes);
+    
+    // covers starting, jumping and looping the transport too
+    if (currentClock != lastClock)
+        brokenPlayer.scheduleClockedPulse(0);
+    
+    if (quarterNotesPerSample > 0.0)
+    {
+        while (true)
+        {
+            const int offset = juce::roundToInt(((currentClock + 1) * gridQuarterNotes - quarterNotes) / quarterNotesPerSample);
+            if (offset >= numSamples)
+                break;
+            
+            brokenPlayer.scheduleClockedPulse(offset);
+            currentClock += 1;
+        }
+    }
+    
+    lastClock = currentClock;
+}
+
 //==============================================================================
 bool RSBrokenMediaAudioProcessor::hasEditor() const
 {
@@ -332,3 +392,7 @@ void RSBrokenMediaAudioProcessor::setUseDawClock(bool shouldUseDawClock)
     auto externalClockParameter = parameters.getParameter("clockSpeedNote");
     externalClockParameter->setValueNotifyingHost(externalClockParameter->getDefaultValue());
 }
+
+void RSBrokenMediaAudioProcessor::setRandomSeed(std::optional<uint64_t> newSeed) { brokenPlayer.setRandomSeed(newSeed); }
+
+juce::AudioPlayHead::PositionInfo RSBrokenMediaAudioProcessor::getLastPositionInfo() const { return lastPosInfo.get(); }
@@ -11,27 +11,13 @@
 #include <JuceHeader.h>
 #include "BrokenPlayer.h"
 #include "CircularBuffer.h"
+#include "AllocationDetector.h"
 #include "LofiProcessors.h"
+#include "ParameterCache.h"
 #include "Utilities.h"
 
-struct ProcessorFactory
-{
-    std::unique_ptr<LofiProcessorBase> create(int type)
-    {
-        auto iter = processorMapping.find(type);
-        if (iter != processorMapping.end())
-            return iter->second();
-        
-        return nullptr;
-    }
-    
-    std::map<int,
-             std::function<std::unique_ptr<LofiProcessorBase>()>> processorMapping
-    {
-        { 1, []() { return std::make_unique<MuLawProcessor>(); } },
-        { 2, []() { return std::make_unique<GSMProcessor>(); } }
-    };
-};
+// the "Codec" menu after "None", in order
+using CodecRegistry = LofiProcessorRegistry<1, MuLawProcessor, GSMProcessor, ALawProcessor, AdpcmProcessor>;
 
 //==============================================================================
 /**
@@ -81,23 +67,34 @@ public:
     
     //==============================================================================
     void setUseDawClock(bool shouldUseDawClock);
+    
+    // repeatable glitches for offline renders; nullopt (the default) reseeds on every prepare
+    void setRandomSeed(std::optional<uint64_t> newSeed);
+    
+    // the transport as of the last processed block; safe from any thread
+    juce::AudioPlayHead::PositionInfo getLastPositionInfo() const;
 private:
+    // hands brokenPlayer a pulse for every gridQuarterNotes line the coming block crosses
+    void scheduleDawClockPulses(const juce::AudioPlayHead::PositionInfo& posInfo, double gridQuarterNotes, int numSamples);
+    
     juce::AudioProcessorValueTreeState parameters;
+    ParameterCache parameterCache;
     
     juce::AudioPlayHead* audioPlayHead { nullptr };
-    LockGuardedPosInfo lastPosInfo;
+    TransportSnapshot lastPosInfo;
     bool useDawClock { false };
-    float lastClock { -1 };
+    double lastClock { -1 };
+    static constexpr std::array<float, 10> clockNoteValues { 16.0f, 8.0f, 4.0f, 3.0f, 2.0f, 1.5f, 1.0f, 0.75f, 0.5f, 0.25f };
     
-    ProcessorFactory processorFactory {};
-    std::unique_ptr<LofiProcessorBase> slotProcessor = std::unique_ptr<LofiProcessorBase> {};
+    // codecs - all held in place and prepared in prepareToPlay, only selected on the audio thread
+    CodecRegistry codecs;
     LofiProcessorParameters processorParameters;
     
     BrokenPlayer brokenPlayer;
-    juce::dsp::DryWetMixer<float> dryWetMixer;
     
-    int slotCodec { 0 };
-    int prevSlotCodec { 0 };
+    // GSM's longest delay (spread load at 192 kHz) is under 9000 samples
+    static constexpr int maxCodecLatency { 16384 };
+    juce::dsp::DryWetMixer<float> dryWetMixer { maxCodecLatency };
     
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RSBrokenMediaAudioProcessor)
@@ -0,0 +1,329 @@
+/*
+  ==============================================================================
+
+    Polyphase resampler implementation
+
+  ==============================================================================
+*/
+
+#include "PolyphaseResampler.h"
+#include <numeric>
+
+namespace
+{
+    // four running sums, so the adds don't wait on each other
+    float dot(const float* taps, const float* samples, int numTaps) noexcept
+    {
+        float sums[4] { 0.0f, 0.0f, 0.0f, 0.0f };
+        int tap = 0;
+
+        for (; tap + 4 <= numTaps; tap += 4)
+        {
+            sums[0] += taps[tap] * samples[tap];
+            sums[1] += taps[tap + 1] * samples[tap + 1];
+            sums[2] += taps[tap + 2] * samples[tap + 2];
+            sums[3] += taps[tap + 3] * samples[tap + 3];
+        }
+
+        for (; tap < numTaps; ++tap)
+            sums[0] += taps[tap] * samples[tap];
+
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+
+    // Kaiser-windowed sinc with unity gain at DC; cutoff in cycles per sample
+    std::vector<float> designLowpass(int numTaps, double cutoff)
+    {
+        std::vector<float> prototype(static_cast<size_t>(numTaps));
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(prototype.data(), prototype.size(),
+                                                                 juce::dsp::WindowingFunction<float>::kaiser, false, 8.0f);
+
+        const double centre = 0.5 * (numTaps - 1);
+        double sum = 0.0;
+
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            const double x = 2.0 * cutoff * (tap - centre);
+            const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+            prototype[static_cast<size_t>(tap)] *= static_cast<float>(2.0 * cutoff * sinc);
+            sum += prototype[static_cast<size_t>(tap)];
+        }
+
+        for (auto& tap : prototype)
+            tap = static_cast<float>(tap / sum);
+
+        return prototype;
+    }
+}
+
+//==============================================================================
+void PolyphaseResampler::prepare(int numChannels, int maximumBlockSize, double sampleRate)
+{
+    mNumChannels = numChannels;
+    mMaximumBlockSize = std::max(1, maximumBlockSize);
+
+    for (int factor = 1; factor <= mMaxFactor; ++factor)
+    {
+        const int numTaps = factor * mTapsPerPhase;
+
+        // cut off at 0.4 of the reduced rate like the old Butterworth filters
+        const auto prototype = designLowpass(numTaps, 0.4 / factor);
+
+        auto& decimation = mDecimationTaps[static_cast<size_t>(factor - 1)];
+        decimation.assign(prototype.rbegin(), prototype.rend());
+
+        // phase p holds h[p], h[p + factor], ... reversed, so it lines up with the oldest sample first
+        auto& interpolation = mInterpolationTaps[static_cast<size_t>(factor - 1)];
+        interpolation.resize(static_cast<size_t>(numTaps));
+
+        for (int phase = 0; phase < factor; ++phase)
+            for (int tap = 0; tap < mTapsPerPhase; ++tap)
+                interpolation[static_cast<size_t>(phase * mTapsPerPhase + tap)] = static_cast<float>(factor) * prototype[static_cast<size_t>(phase + (mTapsPerPhase - 1 - tap) * factor)];
+    }
+
+    mInputLines.assign(static_cast<size_t>(numChannels), std::vector<float>(static_cast<size_t>(mInputHistory + mMaximumBlockSize)));
+
+    for (auto& path : mPaths)
+    {
+        path.lines.assign(static_cast<size_t>(numChannels), std::vector<float>(static_cast<size_t>(mTapsPerPhase + mMaximumBlockSize)));
+        path.reduced.setSize(numChannels, mMaximumBlockSize);
+    }
+
+    mFadeScratch.resize(static_cast<size_t>(mMaximumBlockSize));
+    mFadeLength = std::max(1, juce::roundToInt(sampleRate * mFadeTime));
+
+    reset();
+}
+
+void PolyphaseResampler::setFactor(int newFactor) noexcept
+{
+    newFactor = std::clamp(newFactor, 1, mMaxFactor);
+    if (newFactor == mPaths[0].factor)
+        return;
+
+    // the outgoing path carries on in the second slot; one that was still
+    // fading out from an earlier change is dropped
+    std::swap(mPaths[0], mPaths[1]);
+
+    auto& path = mPaths[0];
+    path.factor = newFactor;
+    path.phase = 0;
+    path.numReduced = 0;
+
+    for (auto& line : path.lines)
+        std::fill(line.begin(), line.end(), 0.0f);
+
+    mFadeRemaining = mFadeLength;
+}
+
+void PolyphaseResampler::reset() noexcept
+{
+    for (auto& line : mInputLines)
+        std::fill(line.begin(), line.end(), 0.0f);
+
+    for (auto& path : mPaths)
+    {
+        for (auto& line : path.lines)
+            std::fill(line.begin(), line.end(), 0.0f);
+
+        path.reduced.clear();
+        path.numReduced = 0;
+        path.phase = 0;
+    }
+
+    mFadeRemaining = 0;
+}
+
+int PolyphaseResampler::decimate(const float* const* input, int numChannels, int startSample, int numSamples) noexcept
+{
+    jassert(numSamples <= mMaximumBlockSize);
+    numSamples = std::min(numSamples, mMaximumBlockSize);
+    numChannels = std::min(numChannels, mNumChannels);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* line = mInputLines[static_cast<size_t>(channel)].data();
+        std::copy(input[channel] + startSample, input[channel] + startSample + numSamples, line + mInputHistory);
+
+        for (int path = 0; path < getNumActivePaths(); ++path)
+            decimatePath(mPaths[static_cast<size_t>(path)], line, mPaths[static_cast<size_t>(path)].reduced.getWritePointer(channel), numSamples);
+
+        std::copy(line + numSamples, line + numSamples + mInputHistory, line);
+    }
+
+    return mPaths[0].numReduced;
+}
+
+void PolyphaseResampler::interpolate(float* const* output, int numChannels, int startSample, int numSamples) noexcept
+{
+    numSamples = std::min(numSamples, mMaximumBlockSize);
+    numChannels = std::min(numChannels, mNumChannels);
+
+    const bool fading = getNumActivePaths() > 1;
+    const int numFading = std::min(numSamples, mFadeRemaining);
+    const float fadeStep = 1.0f / static_cast<float>(mFadeLength);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* destination = output[channel] + startSample;
+        interpolatePath(mPaths[0], channel, destination, numSamples);
+
+        if (fading)
+        {
+            // a linear crossfade - both paths are delayed alike, so only their band limits differ
+            interpolatePath(mPaths[1], channel, mFadeScratch.data(), numSamples);
+
+            for (int sample = 0; sample < numFading; ++sample)
+            {
+                const float outgoing = static_cast<float>(mFadeRemaining - sample) * fadeStep;
+                destination[sample] += outgoing * (mFadeScratch[static_cast<size_t>(sample)] - destination[sample]);
+            }
+        }
+    }
+
+    for (int path = 0; path < (fading ? 2 : 1); ++path)
+        mPaths[static_cast<size_t>(path)].phase = (mPaths[static_cast<size_t>(path)].phase + numSamples) % mPaths[static_cast<size_t>(path)].factor;
+
+    mFadeRemaining -= numFading;
+}
+
+//==============================================================================
+// only every factor-th output is worked out, starting where the last block left off
+void PolyphaseResampler::decimatePath(Path& path, const float* line, float* reduced, int numSamples) const noexcept
+{
+    const int numTaps = path.factor * mTapsPerPhase;
+    const auto* taps = mDecimationTaps[static_cast<size_t>(path.factor - 1)].data();
+
+    // each window starts mInputHistory samples back, which pads this filter and
+    // the interpolation's out to the x8 pair's delay, mInputHistory in all
+    int numReduced = 0;
+    for (int sample = (path.factor - path.phase) % path.factor; sample < numSamples; sample += path.factor)
+        reduced[numReduced++] = path.factor == 1 ? line[sample]
+                                                 : dot(taps, line + sample, numTaps);
+
+    path.numReduced = numReduced;
+}
+
+void PolyphaseResampler::interpolatePath(Path& path, int channel, float* destination, int numSamples) const noexcept
+{
+    const auto* phases = mInterpolationTaps[static_cast<size_t>(path.factor - 1)].data();
+    auto* line = path.lines[static_cast<size_t>(channel)].data();
+    const auto* reduced = path.reduced.getReadPointer(channel);
+    std::copy(reduced, reduced + path.numReduced, line + mTapsPerPhase);
+
+    // line[newest] is the latest reduced sample at or before the current host sample
+    int newest = mTapsPerPhase - 1;
+    int phase = path.phase;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        if (phase == 0)
+            ++newest;
+
+        destination[sample] = path.factor == 1 ? line[newest]
+                                               : dot(phases + phase * mTapsPerPhase, line + newest - mTapsPerPhase + 1, mTapsPerPhase);
+
+        if (++phase == path.factor)
+            phase = 0;
+    }
+
+    std::copy(line + path.numReduced, line + path.numReduced + mTapsPerPhase, line);
+}
+
+//==============================================================================
+void FixedRatioResampler::prepare(int numChannels, double inputRate, double outputRate, int maximumInputBlockSize)
+{
+    const int input = juce::roundToInt(inputRate);
+    const int output = juce::roundToInt(outputRate);
+    const int divisor = std::gcd(input, output);
+
+    mNumChannels = numChannels;
+    mUpFactor = output / divisor;
+    mDownFactor = input / divisor;
+
+    // long enough to span mLowRateSpan samples of whichever rate is lower
+    mTapsPerPhase = (mLowRateSpan * std::max(mUpFactor, mDownFactor) + mUpFactor - 1) / mUpFactor;
+
+    const int numTaps = mUpFactor * mTapsPerPhase;
+    const auto prototype = designLowpass(numTaps, mPassband * 0.5 / std::max(mUpFactor, mDownFactor));
+
+    mPhaseTaps.resize(static_cast<size_t>(numTaps));
+    for (int phase = 0; phase < mUpFactor; ++phase)
+        for (int tap = 0; tap < mTapsPerPhase; ++tap)
+            mPhaseTaps[static_cast<size_t>(phase * mTapsPerPhase + tap)] = static_cast<float>(mUpFactor) * prototype[static_cast<size_t>(phase + (mTapsPerPhase - 1 - tap) * mUpFactor)];
+
+    // history, input not used up yet (under one output's worth), and a new block
+    const int maxInput = std::max(1, maximumInputBlockSize);
+    mLines.assign(static_cast<size_t>(numChannels), std::vector<float>(static_cast<size_t>(mTapsPerPhase + mDownFactor / mUpFactor + 1 + maxInput)));
+    mMaximumOutputBlockSize = static_cast<int>((static_cast<int64_t>(maxInput) * mUpFactor) / mDownFactor) + 2;
+
+    reset();
+}
+
+void FixedRatioResampler::reset() noexcept
+{
+    for (auto& line : mLines)
+        std::fill(line.begin(), line.end(), 0.0f);
+
+    mFill = mTapsPerPhase - 1;
+    mNewest = mTapsPerPhase - 1;
+    mPhase = 0;
+}
+
+void FixedRatioResampler::push(const float* const* input, int numChannels, int startSample, int numSamples) noexcept
+{
+    numChannels = std::min(numChannels, mNumChannels);
+
+    jassert(mLines.empty() || mFill + numSamples <= static_cast<int>(mLines[0].size()));
+    if (! mLines.empty())
+        numSamples = std::min(numSamples, static_cast<int>(mLines[0].size()) - mFill);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        std::copy(input[channel] + startSample, input[channel] + startSample + numSamples, mLines[static_cast<size_t>(channel)].data() + mFill);
+
+    mFill += numSamples;
+}
+
+int FixedRatioResampler::pull(float* const* output, int numChannels, int startSample, int maxSamples) noexcept
+{
+    numChannels = std::min(numChannels, mNumChannels);
+
+    int newest = mNewest;
+    int phase = mPhase;
+    int numOutput = 0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* line = mLines[static_cast<size_t>(channel)].data();
+        auto* destination = output[channel] + startSample;
+
+        newest = mNewest;
+        phase = mPhase;
+        numOutput = 0;
+
+        while (numOutput < maxSamples && newest < mFill)
+        {
+            destination[numOutput++] = dot(mPhaseTaps.data() + phase * mTapsPerPhase, line + newest - mTapsPerPhase + 1, mTapsPerPhase);
+
+            phase += mDownFactor;
+            newest += phase / mUpFactor;
+            phase %= mUpFactor;
+        }
+    }
+
+    // keep only the history the next output needs, and what it hasn't reached yet
+    const int consumed = std::min(newest - (mTapsPerPhase - 1), mFill);
+    if (consumed > 0)
+    {
+        for (auto& line : mLines)
+            std::copy(line.begin() + consumed, line.begin() + mFill, line.begin());
+
+        mFill -= consumed;
+        newest -= consumed;
+    }
+
+    mNewest = newest;
+    mPhase = phase;
+
+    return numOutput;
+}
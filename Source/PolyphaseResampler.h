@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    Polyphase resampler interface
+    - integer-factor FIR decimation and interpolation, so a codec can run at
+      the reduced rate between the two; only the outputs that are kept are
+      ever computed
+    - the filters for every factor are designed in prepare(), and changing
+      factor crossfades from the old path to the new one; every factor is
+      delayed as much as x8, so the two line up and the latency never moves
+    - FixedRatioResampler converts between two fixed rates (e.g. 44.1 kHz and
+      GSM's 8 kHz) by any rational ratio
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class PolyphaseResampler
+{
+public:
+    // designs the filters for every factor up to mMaxFactor
+    void prepare(int numChannels, int maximumBlockSize, double sampleRate);
+
+    // 1 passes straight through; a change fades over mFadeTime
+    void setFactor(int newFactor) noexcept;
+
+    int getFactor() const noexcept { return mPaths[0].factor; }
+
+    // the x8 filters' group delay, in host samples, whatever the factor
+    int getLatency() const noexcept { return mInputHistory; }
+
+    int getMaximumBlockSize() const noexcept { return mMaximumBlockSize; }
+
+    // 2 while the previous factor is fading out, otherwise 1
+    int getNumActivePaths() const noexcept { return mFadeRemaining > 0 ? 2 : 1; }
+
+    void reset() noexcept;
+
+    // low-pass filters and decimates host-rate samples into each active path's
+    // reduced buffer, returning how many reduced-rate samples path 0 got
+    int decimate(const float* const* input, int numChannels, int startSample, int numSamples) noexcept;
+
+    float* getReducedChannel(int channel, int path = 0) noexcept { return mPaths[static_cast<size_t>(path)].reduced.getWritePointer(channel); }
+
+    int getNumReduced(int path = 0) const noexcept { return mPaths[static_cast<size_t>(path)].numReduced; }
+
+    // interpolates the reduced buffers back over the host samples decimate() just read
+    void interpolate(float* const* output, int numChannels, int startSample, int numSamples) noexcept;
+
+private:
+    static constexpr int mMaxFactor { 8 };
+    static constexpr int mTapsPerPhase { 16 };
+    static constexpr int mInputHistory { mMaxFactor * mTapsPerPhase - 1 };
+    static constexpr double mFadeTime { 0.01 }; // seconds
+
+    // one factor's reduced-rate stream
+    struct Path
+    {
+        int factor { 1 };
+        int numReduced { 0 };
+
+        // host samples since the last reduced-rate sample, at the start of the block
+        int phase { 0 };
+
+        juce::AudioBuffer<float> reduced;
+
+        // per channel, the last mTapsPerPhase reduced samples followed by the current ones
+        std::vector<std::vector<float>> lines;
+    };
+
+    void decimatePath(Path& path, const float* line, float* reduced, int numSamples) const noexcept;
+
+    void interpolatePath(Path& path, int channel, float* destination, int numSamples) const noexcept;
+
+    // per factor: the prototype low-pass reversed for decimation, and its phases
+    // (each reversed, scaled by the factor) for interpolation
+    std::array<std::vector<float>, mMaxFactor> mDecimationTaps;
+    std::array<std::vector<float>, mMaxFactor> mInterpolationTaps;
+
+    // per channel, input history followed by the current block - shared by both paths
+    std::vector<std::vector<float>> mInputLines;
+
+    // the current path, then the one fading out
+    std::array<Path, 2> mPaths;
+    std::vector<float> mFadeScratch;
+
+    int mNumChannels { 0 };
+    int mMaximumBlockSize { 0 };
+    int mFadeLength { 0 };
+    int mFadeRemaining { 0 };
+};
+
+//==============================================================================
+class FixedRatioResampler
+{
+public:
+    // designs a low-pass for the ratio, cut off at mPassband of the lower rate's Nyquist
+    void prepare(int numChannels, double inputRate, double outputRate, int maximumInputBlockSize);
+
+    void reset() noexcept;
+
+    // appends input samples; they are used up by pull()
+    void push(const float* const* input, int numChannels, int startSample, int numSamples) noexcept;
+
+    // writes up to maxSamples outputs, as many as the pushed input allows, and returns how many
+    int pull(float* const* output, int numChannels, int startSample, int maxSamples) noexcept;
+
+    // most outputs a full input block can give
+    int getMaximumOutputBlockSize() const noexcept { return mMaximumOutputBlockSize; }
+
+    // the linear-phase filter's group delay, in input samples
+    double getLatency() const noexcept { return (mUpFactor * mTapsPerPhase - 1) / (2.0 * mUpFactor); }
+
+private:
+    static constexpr int mLowRateSpan { 32 }; // filter length, in samples at the lower rate
+    static constexpr double mPassband { 0.875 };
+
+    // up by mUpFactor, filter, down by mDownFactor; only the kept outputs are worked out
+    int mUpFactor { 1 };
+    int mDownFactor { 1 };
+    int mTapsPerPhase { 1 };
+
+    // mUpFactor phases of mTapsPerPhase taps, each reversed and scaled by mUpFactor
+    std::vector<float> mPhaseTaps;
+
+    // per channel, mTapsPerPhase - 1 samples of history followed by unused input
+    std::vector<std::vector<float>> mLines;
+
+    int mNumChannels { 0 };
+    int mMaximumOutputBlockSize { 0 };
+    int mFill { 0 };     // samples in each line
+    int mNewest { 0 };   // line index of the newest input the next output uses
+    int mPhase { 0 };    // where the next output falls past it, in 1/mUpFactor input samples
+};
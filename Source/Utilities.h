@@ -10,10 +10,74 @@
 
 #include <JuceHeader.h>
 
-inline float randomFloat()
+// small per-instance generator (xoshiro128+) - instances neither share state
+// nor contend on the C library's lock, and can be seeded for repeatable output
+class RandomGenerator
 {
-    return static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-}
+public:
+    RandomGenerator() { setSeed(makeUniqueSeed()); }
+    
+    explicit RandomGenerator(uint64_t seed) { setSeed(seed); }
+    
+    void setSeed(uint64_t seed) noexcept
+    {
+        // splitmix64 spreads any seed (including 0) over the whole state
+        for (auto& word : mState)
+        {
+            seed += 0x9e3779b97f4a7c15;
+            uint64_t mixed = seed;
+            mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9;
+            mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111eb;
+            word = static_cast<uint32_t>((mixed ^ (mixed >> 31)) >> 32);
+        }
+    }
+    
+    uint32_t nextUInt32() noexcept
+    {
+        const uint32_t result = mState[0] + mState[3];
+        const uint32_t shifted = mState[1] << 9;
+        
+        mState[2] ^= mState[0];
+        mState[3] ^= mState[1];
+        mState[1] ^= mState[2];
+        mState[0] ^= mState[3];
+        mState[2] ^= shifted;
+        mState[3] = (mState[3] << 11) | (mState[3] >> 21);
+        
+        return result;
+    }
+    
+    uint64_t nextUInt64() noexcept
+    {
+        const uint64_t high = nextUInt32();
+        return (high << 32) | nextUInt32();
+    }
+    
+    // uniform in [0, 1), from the top 24 bits
+    float nextFloat() noexcept { return static_cast<float>(nextUInt32() >> 8) * (1.0f / 16777216.0f); }
+    
+    // uniform in [0, maxValue)
+    int nextInt(int maxValue) noexcept
+    {
+        return static_cast<int>((static_cast<uint64_t>(nextUInt32()) * static_cast<uint64_t>(std::max(maxValue, 0))) >> 32);
+    }
+    
+    void fillUniforms(float* dest, int numValues) noexcept
+    {
+        for (int i = 0; i < numValues; ++i)
+            dest[i] = nextFloat();
+    }
+    
+    // different on every call, so instances created in the same instant still differ
+    static uint64_t makeUniqueSeed() noexcept
+    {
+        static std::atomic<uint64_t> counter { 0 };
+        return static_cast<uint64_t>(juce::Time::getHighResolutionTicks()) ^ (++counter * 0x9e3779b97f4a7c15);
+    }
+    
+private:
+    std::array<uint32_t, 4> mState {};
+};
 
 inline float scale(float input, float inLow, float inHi, float outLow, float outHi)
 {
@@ -28,6 +92,13 @@ inline float wrap(float a, float b)
     return (a >= 0 ? 0 : b) + (mod > __FLT_EPSILON__ || !std::isnan(mod) ? mod : 0);
 }
 
+// SaturationProcessor waveshapers, most accurate first
+enum class saturationKernel { kTanh, kPade, kTable };
+
+// GSMProcessor encoder paths, most faithful first: exact GSM 06.10, the float
+// approximations (GSM_OPT_FAST), and those with the cut lag search (GSM_OPT_LTP_CUT)
+enum class gsmQuality { kExact, kFast, kFastLtpCut };
+
 struct LofiProcessorParameters
 {
     LofiProcessorParameters() {}
@@ -41,6 +112,10 @@ struct LofiProcessorParameters
             downsampling = params.downsampling;
             drive = params.drive;
 //            waveshape = params.waveshape;
+            kernel = params.kernel;
+            antiAliasing = params.antiAliasing;
+            quality = params.quality;
+            spreadLoad = params.spreadLoad;
         }
         return *this;
     }
@@ -49,6 +124,10 @@ struct LofiProcessorParameters
     int downsampling { 1 };
     float drive { 0.0f };
 //    int waveshape { 2 };
+    saturationKernel kernel { saturationKernel::kTanh };
+    bool antiAliasing { false };
+    gsmQuality quality { gsmQuality::kExact };
+    bool spreadLoad { false };
 };
 
 class LofiProcessorBase
@@ -67,27 +146,323 @@ public:
     virtual LofiProcessorParameters& getParameters() = 0;
     
     virtual void setParameters(const LofiProcessorParameters& params) = 0;
+    
+    // delay from input to output at the current settings
+    virtual int getLatencySamples() const { return 0; }
+    
+    // the longest delay any settings give at the prepared rate
+    virtual int getMaxLatencySamples() const { return getLatencySamples(); }
+};
+
+// every processor in a type list, held in place and prepared up front. Types
+// are numbered from firstType in list order, and a type number dispatches
+// straight to the concrete class, so switching type on the audio thread is
+// neither an allocation nor a virtual call. Adding a processor means adding it
+// to the list, with a static menuName for its menu entry.
+// select() crossfades from the running processor to the next over mFadeTime;
+// any other is left idle and costs nothing. Every type's output is delayed to
+// the slowest one's, so the whole registry has one fixed latency, and a fade
+// waits that long for the next processor's output to come through
+template <int firstType, typename... Processors>
+class LofiProcessorRegistry
+{
+public:
+    static_assert((std::is_base_of_v<LofiProcessorBase, Processors> && ...), "registered processors implement LofiProcessorBase");
+    
+    static constexpr int numTypes { static_cast<int>(sizeof...(Processors)) };
+    
+    static constexpr bool contains(int type) noexcept { return type >= firstType && type < firstType + numTypes; }
+    
+    // the menu entries in type order, after any that come before firstType
+    static juce::StringArray getMenuNames(juce::StringArray precedingNames = {})
+    {
+        (precedingNames.add(Processors::menuName), ...);
+        return precedingNames;
+    }
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        std::apply([&spec](auto&... processors) { (processors.prepare(spec), ...); }, mProcessors);
+        
+        mLatency = 0;
+        std::apply([this](const auto&... processors)
+        {
+            ((mLatency = std::max(mLatency, processors.getMaxLatencySamples())), ...);
+        }, mProcessors);
+        
+        for (auto& padding : mPaddings)
+        {
+            padding.line.setSize(static_cast<int>(spec.numChannels), mLatency + 1);
+            padding.line.clear();
+            padding.writeIndex = 0;
+        }
+        
+        // the fade never outlasts the buffer, so the outgoing processor is run in one go
+        mFadeLength = std::max(1, juce::roundToInt(spec.sampleRate * mFadeTime));
+        mFadeBuffer.setSize(static_cast<int>(spec.numChannels), std::max(static_cast<int>(spec.maximumBlockSize), mFadeLength));
+        mFadeRemaining = 0;
+    }
+    
+    // a type that isn't registered passes audio straight through, so fading to
+    // or from it is fading to or from the dry signal. A change while a fade is on
+    // waits for it to finish, so call this every block until it returns true
+    bool select(int type) noexcept
+    {
+        if (type == mSelected || mFadeRemaining > 0)
+            return false;
+        
+        // the incoming processor starts clean
+        visit(type, [](auto& processor)
+        {
+            using Processor = std::decay_t<decltype(processor)>;
+            processor.Processor::reset();
+        });
+        
+        getPadding(type).line.clear();
+        
+        mPrevious = mSelected;
+        mSelected = type;
+        // the outgoing processor plays on alone until the incoming one's output arrives
+        mFadeRemaining = mLatency + mFadeLength;
+        return true;
+    }
+    
+    int getSelected() const noexcept { return mSelected; }
+    
+    // runs the selected processor, and while a fade is on, the previous one on a copy
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+    {
+        if (mFadeRemaining == 0)
+        {
+            processPadded(mSelected, buffer, midiMessages);
+            return;
+        }
+        
+        const int numChannels = std::min(buffer.getNumChannels(), mFadeBuffer.getNumChannels());
+        const int numFading = std::min(buffer.getNumSamples(), mFadeRemaining);
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+            mFadeBuffer.copyFrom(channel, 0, buffer, channel, 0, numFading);
+        
+        // refers to mFadeBuffer's channels rather than allocating its own
+        juce::AudioBuffer<float> outgoing { mFadeBuffer.getArrayOfWritePointers(), numChannels, numFading };
+        processPadded(mPrevious, outgoing, midiMessages);
+        processPadded(mSelected, buffer, midiMessages);
+        
+        // linear, as both carry the same input, equally delayed
+        const float fadeStep = 1.0f / static_cast<float>(mFadeLength);
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* previous = mFadeBuffer.getReadPointer(channel);
+            auto* destination = buffer.getWritePointer(channel);
+            
+            for (int sample = 0; sample < numFading; ++sample)
+            {
+                const float outgoingGain = std::min(1.0f, static_cast<float>(mFadeRemaining - sample) * fadeStep);
+                destination[sample] += outgoingGain * (previous[sample] - destination[sample]);
+            }
+        }
+        
+        mFadeRemaining -= numFading;
+    }
+    
+    // calls function with type's processor as its own class; false if there is none
+    template <typename Function>
+    bool visit(int type, Function&& function)
+    {
+        return visitIndex(*this, type - firstType, function, std::index_sequence_for<Processors...> {});
+    }
+    
+    template <typename Function>
+    bool visit(int type, Function&& function) const
+    {
+        return visitIndex(*this, type - firstType, function, std::index_sequence_for<Processors...> {});
+    }
+    
+    template <typename Processor>
+    Processor& get() noexcept { return std::get<Processor>(mProcessors); }
+    
+    // the calls below are qualified, so they bind statically although the members are virtual
+    void processBlock(int type, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+    {
+        visit(type, [&](auto& processor)
+        {
+            using Processor = std::decay_t<decltype(processor)>;
+            processor.Processor::processBlock(buffer, midiMessages);
+        });
+    }
+    
+    // nullptr if type isn't registered
+    LofiProcessorParameters* getParameters(int type) noexcept
+    {
+        LofiProcessorParameters* params = nullptr;
+        visit(type, [&params](auto& processor)
+        {
+            using Processor = std::decay_t<decltype(processor)>;
+            params = &processor.Processor::getParameters();
+        });
+        return params;
+    }
+    
+    void setParameters(int type, const LofiProcessorParameters& params)
+    {
+        visit(type, [&params](auto& processor)
+        {
+            using Processor = std::decay_t<decltype(processor)>;
+            processor.Processor::setParameters(params);
+        });
+    }
+    
+    // every type's, once padded; fixed from one prepare to the next
+    int getLatencySamples() const noexcept { return mLatency; }
+    
+    // type's own, before padding
+    int getLatencySamples(int type) const
+    {
+        int latency = 0;
+        visit(type, [&latency](const auto& processor)
+        {
+            using Processor = std::decay_t<decltype(processor)>;
+            latency = processor.Processor::getLatencySamples();
+        });
+        return latency;
+    }
+    
+private:
+    // a delay line that makes up the difference between a type's latency and mLatency
+    struct Padding
+    {
+        juce::AudioBuffer<float> line;
+        int writeIndex { 0 };
+    };
+    
+    // unregistered types share the last one
+    Padding& getPadding(int type) noexcept
+    {
+        return mPaddings[static_cast<size_t>(contains(type) ? type - firstType : numTypes)];
+    }
+    
+    void processPadded(int type, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+    {
+        processBlock(type, buffer, midiMessages);
+        
+        if (mLatency == 0)
+            return;
+        
+        auto& padding = getPadding(type);
+        const int delay = mLatency - getLatencySamples(type);
+        const int size = padding.line.getNumSamples();
+        const int numChannels = std::min(buffer.getNumChannels(), padding.line.getNumChannels());
+        const int numSamples = buffer.getNumSamples();
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+            auto* line = padding.line.getWritePointer(channel);
+            int write = padding.writeIndex;
+            
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                line[write] = data[sample];
+                const int read = write >= delay ? write - delay : write - delay + size;
+                data[sample] = line[read];
+                
+                if (++write == size)
+                    write = 0;
+            }
+        }
+        
+        padding.writeIndex = (padding.writeIndex + numSamples) % size;
+    }
+    
+    // one comparison per registered type, which the compiler can fold into a jump table
+    template <typename Registry, typename Function, size_t... indices>
+    static bool visitIndex(Registry& registry, int index, Function& function, std::index_sequence<indices...>)
+    {
+        return ((index == static_cast<int>(indices) && (function(std::get<indices>(registry.mProcessors)), true)) || ...);
+    }
+    
+    std::tuple<Processors...> mProcessors;
+    
+    static constexpr double mFadeTime { 0.01 }; // seconds
+    
+    int mSelected { firstType - 1 };
+    int mPrevious { firstType - 1 };
+    
+    juce::AudioBuffer<float> mFadeBuffer;
+    int mFadeLength { 1 };
+    int mFadeRemaining { 0 };
+    
+    std::array<Padding, numTypes + 1> mPaddings;
+    int mLatency { 0 };
 };
 
-class LockGuardedPosInfo
+// single-writer seqlock: the writer (the audio thread) never waits, and any
+// number of readers copy a consistent snapshot by retrying if a write overlapped.
+// The payload lives in relaxed atomic words, so a torn read is detected rather
+// than being a data race
+template <typename Value>
+class SeqLockSnapshot
 {
 public:
-    void set(const juce::AudioPlayHead::PositionInfo& newInfo)
+    static_assert(std::is_trivially_copyable_v<Value>, "snapshots are copied word by word");
+    
+    void set(const Value& newValue) noexcept
     {
-        const std::lock_guard<std::mutex> lock(mMutex);
-        mInfo = newInfo;
+        std::array<uint64_t, mNumWords> words {};
+        std::memcpy(words.data(), &newValue, sizeof(Value));
+        
+        // odd while the words are being written
+        const auto sequence = mSequence.load(std::memory_order_relaxed);
+        mSequence.store(sequence + 1, std::memory_order_relaxed);
+        
+        // a reader that sees any of these words also sees the odd sequence
+        for (size_t word = 0; word < mNumWords; ++word)
+            mWords[word].store(words[word], std::memory_order_release);
+        
+        mSequence.store(sequence + 2, std::memory_order_release);
     }
     
-    juce::AudioPlayHead::PositionInfo get() noexcept
+    // never blocks the writer; spins only while a write is in flight
+    Value get() const noexcept
     {
-        const std::lock_guard<std::mutex> lock(mMutex);
-        return mInfo;
+        Value value;
+        
+        while (! tryGet(value))
+            std::this_thread::yield();
+        
+        return value;
     }
+    
+    // a single attempt, for callers that must not spin
+    bool tryGet(Value& dest) const noexcept
+    {
+        std::array<uint64_t, mNumWords> words;
+        
+        const auto before = mSequence.load(std::memory_order_acquire);
+        if ((before & 1) != 0)
+            return false;
+        
+        for (size_t word = 0; word < mNumWords; ++word)
+            words[word] = mWords[word].load(std::memory_order_acquire);
+        
+        if (mSequence.load(std::memory_order_relaxed) != before)
+            return false;
+        
+        std::memcpy(&dest, words.data(), sizeof(Value));
+        return true;
+    }
+    
 private:
-    std::mutex mMutex;
-    juce::AudioPlayHead::PositionInfo mInfo;
+    static constexpr size_t mNumWords { (sizeof(Value) + sizeof(uint64_t) - 1) / sizeof(uint64_t) };
+    
+    std::atomic<uint32_t> mSequence { 0 };
+    std::array<std::atomic<uint64_t>, mNumWords> mWords {};
 };
 
+using TransportSnapshot = SeqLockSnapshot<juce::AudioPlayHead::PositionInfo>;
+
 /*
 inline float randomFloatStdDev(float mean = 0, float stdDev = 1)
 {
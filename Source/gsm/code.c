@@ -56,42 +56,69 @@ void Gsm_Coder P8((S,s,LARc,Nc,bc,Mc,xmaxc,xMc),
 )
 {
 	int	k;
-	word	* dp  = S->dp0 + 120;	/* [ -120...-1 ] */
-	word	* dpp = dp;		/* [ 0...39 ]	 */
-
 	word	so[160];
 
+	Gsm_Coder_Analysis( S, s, so, LARc );
+
+	for (k = 0; k <= 3; k++, xMc += 13)
+		Gsm_Coder_Subsegment( S, so, k, Nc++, bc++, Mc++, xmaxc++, xMc );
+}
+
+/*
+ *  Gsm_Coder in the pieces it is made of, for callers that spread a
+ *  frame's work out: the frame-wide part, then each sub-segment k = 0..3
+ *  in order.  so[] carries the short term residual from one to the next.
+ */
+
+void Gsm_Coder_Analysis P4((S,s,so,LARc),
+	struct gsm_state	* S,
+	word	* s,	/* [0..159] samples		  	IN	*/
+	word	* so,	/* [0..159] short term residual		OUT	*/
+	word	* LARc	/* [0..7] LAR coefficients		OUT	*/
+)
+{
 	Gsm_Preprocess			(S, s, so);
 	Gsm_LPC_Analysis		(S, so, LARc);
 	Gsm_Short_Term_Analysis_Filter	(S, LARc, so);
+}
 
-	for (k = 0; k <= 3; k++, xMc += 13) {
-
-		Gsm_Long_Term_Predictor	( S,
-					 so+k*40, /* d      [0..39] IN	*/
-					 dp,	  /* dp  [-120..-1] IN	*/
-					S->e + 5, /* e      [0..39] OUT	*/
-					dpp,	  /* dpp    [0..39] OUT */
-					 Nc++,
-					 bc++);
-
-		Gsm_RPE_Encoding	( S,
-					S->e + 5,/* e	  ][0..39][ IN/OUT */
-					  xmaxc++, Mc++, xMc );
-		/*
-		 * Gsm_Update_of_reconstructed_short_time_residual_signal
-		 *			( dpp, S->e + 5, dp );
-		 */
-
-		{ register int i;
-		  register longword ltmp;
-		  for (i = 0; i <= 39; i++)
-			dp[ i ] = GSM_ADD( S->e[5 + i], dpp[i] );
-		}
-		dp  += 40;
-		dpp += 40;
-
+void Gsm_Coder_Subsegment P8((S,so,k,Nc,bc,Mc,xmaxc,xMc),
+	struct gsm_state	* S,
+	word	* so,	/* [0..159] short term residual		IN	*/
+	int	k,	/* sub-segment, 0..3				*/
+	word	* Nc,	/* LTP lag				OUT 	*/
+	word	* bc,	/* coded LTP gain			OUT 	*/
+	word	* Mc,	/* RPE grid selection			OUT     */
+	word	* xmaxc,/* coded maximum amplitude		OUT	*/
+	word	* xMc	/* [0..12] normalized RPE samples	OUT	*/
+)
+{
+	word	* dp  = S->dp0 + 120 + k * 40;	/* [ -120...-1 ] */
+	word	* dpp = dp;			/* [ 0...39 ]	 */
+
+	Gsm_Long_Term_Predictor	( S,
+				 so+k*40, /* d      [0..39] IN	*/
+				 dp,	  /* dp  [-120..-1] IN	*/
+				S->e + 5, /* e      [0..39] OUT	*/
+				dpp,	  /* dpp    [0..39] OUT */
+				 Nc,
+				 bc);
+
+	Gsm_RPE_Encoding	( S,
+				S->e + 5,/* e	  ][0..39][ IN/OUT */
+				  xmaxc, Mc, xMc );
+	/*
+	 * Gsm_Update_of_reconstructed_short_time_residual_signal
+	 *			( dpp, S->e + 5, dp );
+	 */
+
+	{ register int i;
+	  register longword ltmp;
+	  for (i = 0; i <= 39; i++)
+		dp[ i ] = GSM_ADD( S->e[5 + i], dpp[i] );
 	}
-	(void)memcpy( (char *)S->dp0, (char *)(S->dp0 + 160),
-		120 * sizeof(*S->dp0) );
+
+	if (k == 3)
+		(void)memcpy( (char *)S->dp0, (char *)(S->dp0 + 160),
+			120 * sizeof(*S->dp0) );
 }
@@ -46,18 +46,46 @@ void Gsm_Decoder P8((S,LARcr, Ncr,bcr,Mcr,xmaxcr,xMcr,s),
 
 	word		* s)		/* [0..159]		OUT 	*/
 {
-	int		j, k;
-	word		erp[40], wt[160];
-	word		* drp = S->dp0 + 120;
+	int		j;
+	word		wt[160];
 
-	for (j=0; j <= 3; j++, xmaxcr++, bcr++, Ncr++, Mcr++, xMcr += 13) {
+	for (j=0; j <= 3; j++, xmaxcr++, bcr++, Ncr++, Mcr++, xMcr += 13)
+		Gsm_Decoder_Subsegment( S, j, *Ncr, *bcr, *Mcr, *xmaxcr, xMcr, wt );
 
-		Gsm_RPE_Decoding( S, *xmaxcr, *Mcr, xMcr, erp );
-		Gsm_Long_Term_Synthesis_Filtering( S, *Ncr, *bcr, erp, drp );
+	Gsm_Decoder_Synthesis( S, LARcr, wt, s );
+}
 
-		for (k = 0; k <= 39; k++) wt[ j * 40 + k ] =  drp[ k ];
-	}
+/*
+ *  Gsm_Decoder in the pieces it is made of: each sub-segment j = 0..3 in
+ *  order, filling wt[], then the frame-wide synthesis.
+ */
+
+void Gsm_Decoder_Subsegment P8((S,j,Ncr,bcr,Mcr,xmaxcr,xMcr,wt),
+	struct gsm_state	* S,
+	int		j,		/* sub-segment, 0..3		*/
+	word		Ncr,		/* 			IN 	*/
+	word		bcr,		/* 			IN	*/
+	word		Mcr,		/* 			IN 	*/
+	word		xmaxcr,		/* 			IN 	*/
+	word		* xMcr,		/* [0..12]		IN	*/
+	word		* wt)		/* [0..159]		OUT	*/
+{
+	int		k;
+	word		erp[40];
+	word		* drp = S->dp0 + 120;
+
+	Gsm_RPE_Decoding( S, xmaxcr, Mcr, xMcr, erp );
+	Gsm_Long_Term_Synthesis_Filtering( S, Ncr, bcr, erp, drp );
+
+	for (k = 0; k <= 39; k++) wt[ j * 40 + k ] =  drp[ k ];
+}
 
+void Gsm_Decoder_Synthesis P4((S,LARcr,wt,s),
+	struct gsm_state	* S,
+	word		* LARcr,	/* [0..7]		IN	*/
+	word		* wt,		/* [0..159]		IN	*/
+	word		* s)		/* [0..159]		OUT 	*/
+{
 	Gsm_Short_Term_Synthesis_Filter( S, LARcr, wt, s );
 	Postprocessing(S, s);
 }
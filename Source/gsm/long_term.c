@@ -42,9 +42,14 @@
   * Harmful''.)
   */
 
-#ifndef  USE_FLOAT_MUL
+/* With SSE2 the uncut integer version is both exact and the quickest,
+ * so it is used even when USE_FLOAT_MUL is defined for the FAST versions.
+ * The two Cut versions pick different lags, so that one stays float
+ * whenever USE_FLOAT_MUL is defined, with or without SSE2.
+ */
+#if !defined(USE_FLOAT_MUL) || defined(GSM_SIMD)
 
-#ifdef	LTP_CUT
+#if defined(LTP_CUT) && !defined(USE_FLOAT_MUL)
 
 static void Cut_Calculation_of_the_LTP_parameters P5((st, d,dp,bc_out,Nc_out),
 
@@ -70,6 +75,7 @@ static void Cut_Calculation_of_the_LTP_parameters P5((st, d,dp,bc_out,Nc_out),
 	/*  Search of the optimum scaling of d[0..39].
 	 */
 	dmax = 0;
+	best_k = 0;	/* silence would otherwise leave it undefined */
 	for (k = 0; k <= 39; k++) {
 		temp = d[k];
 		temp = GSM_ABS( temp );
@@ -200,6 +206,46 @@ static void Calculation_of_the_LTP_parameters P4((d,dp,bc_out,Nc_out),
 	L_max = 0;
 	Nc    = 40;	/* index for the maximum cross-correlation */
 
+#ifdef	GSM_SIMD
+	{
+		/*  |wt[k]| <= 512, so each lag's 40 products sum exactly
+		 *  in 32 bits.  Four lags per pass, 40..119, then 120.
+		 */
+		__m128i		w[5], acc[4];
+		int		L_results[4], j;
+
+#		define LAG_ACC(lag)	\
+		(_mm_add_epi32( _mm_add_epi32(	\
+			_mm_madd_epi16( w[0], _mm_loadu_si128( (__m128i *)(dp - (lag)) )), \
+			_mm_madd_epi16( w[1], _mm_loadu_si128( (__m128i *)(dp - (lag) + 8) ))), \
+		 _mm_add_epi32( _mm_add_epi32(	\
+			_mm_madd_epi16( w[2], _mm_loadu_si128( (__m128i *)(dp - (lag) + 16) )), \
+			_mm_madd_epi16( w[3], _mm_loadu_si128( (__m128i *)(dp - (lag) + 24) ))), \
+			_mm_madd_epi16( w[4], _mm_loadu_si128( (__m128i *)(dp - (lag) + 32) )))))
+
+		for (k = 0; k < 5; k++)
+			w[k] = _mm_loadu_si128( (__m128i *)(wt + 8 * k) );
+
+		for (lambda = 40; lambda <= 120; lambda += 4) {
+
+			int n = lambda == 120 ? 1 : 4;
+
+			for (j = 0; j < n; j++) acc[j] = LAG_ACC( lambda + j );
+			for (; j < 4; j++)      acc[j] = acc[0];
+
+			_mm_storeu_si128( (__m128i *)L_results,
+				gsm_sum4_epi32( acc[0], acc[1], acc[2], acc[3] ));
+
+			for (j = 0; j < n; j++) if (L_results[j] > L_max) {
+
+				Nc    = lambda + j;
+				L_max = L_results[j];
+			}
+		}
+
+#		undef LAG_ACC
+	}
+#else	/* !GSM_SIMD */
 	for (lambda = 40; lambda <= 120; lambda++) {
 
 # undef STEP
@@ -234,6 +280,7 @@ static void Calculation_of_the_LTP_parameters P4((d,dp,bc_out,Nc_out),
 			L_max = L_result;
 		}
 	}
+#endif	/* GSM_SIMD */
 
 	*Nc_out = Nc;
 
@@ -286,8 +333,9 @@ static void Calculation_of_the_LTP_parameters P4((d,dp,bc_out,Nc_out),
 	*bc_out = bc;
 }
 
-#else	/* USE_FLOAT_MUL */
+#endif	/* !USE_FLOAT_MUL || GSM_SIMD */
 
+#ifdef	USE_FLOAT_MUL
 #ifdef	LTP_CUT
 
 static void Cut_Calculation_of_the_LTP_parameters P5((st, d,dp,bc_out,Nc_out),
@@ -467,6 +515,7 @@ static void Cut_Calculation_of_the_LTP_parameters P5((st, d,dp,bc_out,Nc_out),
 }
 
 #endif /* LTP_CUT */
+#ifndef	GSM_SIMD
 
 static void Calculation_of_the_LTP_parameters P4((d,dp,bc_out,Nc_out),
 	register word	* d,		/* [0..39]	IN	*/
@@ -631,7 +680,10 @@ static void Calculation_of_the_LTP_parameters P4((d,dp,bc_out,Nc_out),
 	*bc_out = bc;
 }
 
-#ifdef	FAST
+#endif	/* !GSM_SIMD */
+#endif	/* USE_FLOAT_MUL */
+
+#if defined(FAST) && defined(USE_FLOAT_MUL)
 #ifdef	LTP_CUT
 
 static void Cut_Fast_Calculation_of_the_LTP_parameters P5((st,
@@ -646,13 +698,15 @@ static void Cut_Fast_Calculation_of_the_LTP_parameters P5((st,
 	register int  	k, lambda;
 	register float	wt_float;
 	word		Nc, bc;
-	word		wt_max, best_k, ltp_cut;
+	word		wt_max, best_k;
 
 	float		dp_float_base[120], * dp_float = dp_float_base + 120;
 
 	register float	L_result, L_max, L_power;
 
+	/* best_k stays 0 for a silent sub-segment rather than undefined */
 	wt_max = 0;
+	best_k = 0;
 
 	for (k = 0; k < 40; ++k) {
 		if      ( d[k] > wt_max) wt_max =  d[best_k = k];
@@ -825,8 +879,7 @@ static void Fast_Calculation_of_the_LTP_parameters P4((d,dp,bc_out,Nc_out),
 	*bc_out = bc;
 }
 
-#endif	/* FAST 	 */
-#endif	/* USE_FLOAT_MUL */
+#endif	/* FAST && USE_FLOAT_MUL */
 
 
 /* 4.2.12 */
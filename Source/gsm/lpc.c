@@ -35,7 +35,7 @@ static void Autocorrelation P2((s, L_ACF),
 
 	word		temp, smax, scalauto;
 
-#ifdef	USE_FLOAT_MUL
+#if defined(USE_FLOAT_MUL) && !defined(GSM_SIMD)
 	float		float_s[160];
 #endif
 
@@ -63,7 +63,7 @@ static void Autocorrelation P2((s, L_ACF),
 
 	if (scalauto > 0) {
 
-# ifdef USE_FLOAT_MUL
+# if defined(USE_FLOAT_MUL) && !defined(GSM_SIMD)
 #   define SCALE(n)	\
 	case n: for (k = 0; k <= 159; k++) \
 			float_s[k] = (float)	\
@@ -74,7 +74,7 @@ static void Autocorrelation P2((s, L_ACF),
 	case n: for (k = 0; k <= 159; k++) \
 			s[k] = GSM_MULT_R( s[k], 16384 >> (n-1) );\
 		break;
-# endif /* USE_FLOAT_MUL */
+# endif /* USE_FLOAT_MUL && !GSM_SIMD */
 
 		switch (scalauto) {
 		SCALE(1)
@@ -84,12 +84,47 @@ static void Autocorrelation P2((s, L_ACF),
 		}
 # undef	SCALE
 	}
-# ifdef	USE_FLOAT_MUL
+# if defined(USE_FLOAT_MUL) && !defined(GSM_SIMD)
 	else for (k = 0; k <= 159; k++) float_s[k] = (float) s[k];
 # endif
 
 	/*  Compute the L_ACF[..].
 	 */
+#ifdef	GSM_SIMD
+	{
+		/*  After the scaling |s[k]| <= 2048, so each lag's 160
+		 *  products sum exactly in 32 bits, eight at a time.
+		 *  Zeros in front stand in for s[-8..-1].
+		 */
+		word		padded[ 8 + 160 ];
+		int		sums[ 12 ];
+		__m128i		acc[ 9 ];
+		register word	* sp = padded + 8;
+
+		for (k = 0; k < 8; k++)   padded[k] = 0;
+		for (k = 0; k <= 159; k++) sp[k] = s[k];
+
+		for (k = 0; k < 9; k++) acc[k] = _mm_setzero_si128();
+
+		for (i = 0; i <= 159; i += 8) {
+
+			__m128i	x = _mm_loadu_si128( (__m128i *)(sp + i) );
+
+			for (k = 0; k < 9; k++) acc[k] = _mm_add_epi32( acc[k],
+				_mm_madd_epi16( x, _mm_loadu_si128(
+					(__m128i *)(sp + i - k) )));
+		}
+
+		_mm_storeu_si128( (__m128i *)sums,
+			gsm_sum4_epi32( acc[0], acc[1], acc[2], acc[3] ));
+		_mm_storeu_si128( (__m128i *)(sums + 4),
+			gsm_sum4_epi32( acc[4], acc[5], acc[6], acc[7] ));
+		_mm_storeu_si128( (__m128i *)(sums + 8),
+			gsm_sum4_epi32( acc[8], acc[8], acc[8], acc[8] ));
+
+		for (k = 0; k < 9; k++) L_ACF[k] = (longword)sums[k] << 1;
+	}
+#else	/* !GSM_SIMD */
 	{
 # ifdef	USE_FLOAT_MUL
 		register float * sp = float_s;
@@ -136,6 +171,7 @@ static void Autocorrelation P2((s, L_ACF),
 	for (k = 9; k--; L_ACF[k] <<= 1) ; 
 
 	}
+#endif	/* GSM_SIMD */
 	/*   Rescaling of the array s[0..159]
 	 */
 	if (scalauto > 0) {
@@ -152,7 +188,7 @@ static void Fast_Autocorrelation P2((s, L_ACF),
 {
 	register int	k, i;
 	float f_L_ACF[9];
-	float scale;
+	double scale, L_temp;
 
 	float          s_f[160];
 	register float *sf = s_f;
@@ -164,10 +200,21 @@ static void Fast_Autocorrelation P2((s, L_ACF),
 		for (i = k; i < 160; ++i) L_temp2 += sf[i] * sfl[i];
 		f_L_ACF[k] = L_temp2;
 	}
-	scale = MAX_LONGWORD / f_L_ACF[0];
+	if (f_L_ACF[0] == 0) {
+		for (k = 0; k <= 8; k++) L_ACF[k] = 0;
+		return;
+	}
+
+	/*  In float MAX_LONGWORD rounds up to 2^31, which gsm_norm()
+	 *  can't normalize; scale in double and saturate instead.
+	 */
+	scale = (double)MAX_LONGWORD / f_L_ACF[0];
 
 	for (k = 0; k <= 8; k++) {
-		L_ACF[k] = f_L_ACF[k] * scale;
+		L_temp = f_L_ACF[k] * scale;
+		L_ACF[k] = L_temp >= MAX_LONGWORD ? MAX_LONGWORD
+			 : L_temp <= MIN_LONGWORD ? MIN_LONGWORD
+			 : (longword)L_temp;
 	}
 }
 #endif	/* defined (USE_FLOAT_MUL) && defined (FAST) */
@@ -9,6 +9,18 @@
 #ifndef	PRIVATE_H
 #define	PRIVATE_H
 
+/*
+ *  Build options, normally -D flags in the library's Makefile.  FAST and
+ *  USE_FLOAT_MUL compile the float paths that GSM_OPT_FAST switches to,
+ *  LTP_CUT the cut lag search behind GSM_OPT_LTP_CUT.  Both options start
+ *  off, so a new state still codes exact GSM 06.10.
+ */
+#ifndef	__cplusplus
+#define	FAST		1
+#define	USE_FLOAT_MUL	1
+#define	LTP_CUT		1
+#endif
+
 typedef short			word;		/* 16 bit signed int	*/
 typedef long			longword;	/* 32 bit signed int	*/
 
@@ -138,6 +150,45 @@ extern word	gsm_asr  	P((word a, int n));
 
 */
 
+/*
+ *  SSE2 versions of the encoder's inner loops (lpc.c, long_term.c,
+ *  short_term.c).  They produce the same frames bit for bit; define
+ *  GSM_NO_SIMD to build the plain C loops instead.
+ */
+#if !defined(GSM_NO_SIMD) && !defined(__cplusplus) && (defined(__SSE2__) || defined(_M_X64) \
+	|| (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+
+#define	GSM_SIMD	1
+
+#include <emmintrin.h>
+
+/* the four 32 bit lanes of a, b, c and d each summed, in that order */
+static inline __m128i gsm_sum4_epi32(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+	__m128i	ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b), _mm_unpackhi_epi32(a, b));
+	__m128i	cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d), _mm_unpackhi_epi32(c, d));
+
+	return _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd));
+}
+
+/* GSM_MULT_R on eight words, truncated to a word the same way */
+static inline __m128i gsm_mult_r_epi16(__m128i a, __m128i b)
+{
+	const __m128i	one   = _mm_set1_epi16(1);
+	const __m128i	round = _mm_set1_epi16(16384);
+
+	/* a * b + 16384, then bits 15..30 of it */
+	__m128i	lo = _mm_madd_epi16(_mm_unpacklo_epi16(a, one), _mm_unpacklo_epi16(b, round));
+	__m128i	hi = _mm_madd_epi16(_mm_unpackhi_epi16(a, one), _mm_unpackhi_epi16(b, round));
+
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 1), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 1), 16);
+
+	return _mm_packs_epi32(lo, hi);
+}
+
+#endif	/* SSE2 */
+
 /*
  *  More prototypes from implementations..
  */
@@ -151,6 +202,22 @@ extern void Gsm_Coder P((
 		word	* xmaxc,/* [0..3] Coded maximum amplitude OUT	*/
 		word	* xMc	/* [13*4] normalized RPE samples OUT	*/));
 
+extern void Gsm_Coder_Analysis P((
+		struct gsm_state	* S,
+		word	* s,	/* [0..159] samples		IN	*/
+		word	* so,	/* [0..159] short term residual	OUT	*/
+		word	* LARc	/* [0..7] LAR coefficients	OUT	*/));
+
+extern void Gsm_Coder_Subsegment P((	/* k = 0..3, after Gsm_Coder_Analysis */
+		struct gsm_state	* S,
+		word	* so,	/* [0..159] short term residual	IN	*/
+		int	k,
+		word	* Nc,	/* LTP lag			OUT 	*/
+		word	* bc,	/* coded LTP gain		OUT 	*/
+		word	* Mc,	/* RPE grid selection		OUT     */
+		word	* xmaxc,/* coded maximum amplitude	OUT	*/
+		word	* xMc	/* [0..12] normalized RPE samples OUT	*/));
+
 extern void Gsm_Long_Term_Predictor P((		/* 4x for 160 samples */
 		struct gsm_state * S,
 		word	* d,	/* [0..39]   residual signal	IN	*/
@@ -192,6 +259,22 @@ extern void Gsm_Decoder P((
 		word	* xMcr,		/* [0..13*4]		IN	*/
 		word	* s));		/* [0..159]		OUT 	*/
 
+extern void Gsm_Decoder_Subsegment P((	/* j = 0..3, then the synthesis */
+		struct gsm_state * S,
+		int	j,
+		word	Ncr,
+		word	bcr,
+		word	Mcr,
+		word	xmaxcr,
+		word	* xMcr,		/* [0..12]		IN	*/
+		word	* wt));		/* [0..159]		OUT	*/
+
+extern void Gsm_Decoder_Synthesis P((
+		struct gsm_state * S,
+		word	* LARcr,	/* [0..7]		IN	*/
+		word	* wt,		/* [0..159]		IN	*/
+		word	* s));		/* [0..159]		OUT 	*/
+
 extern void Gsm_Decoding P((
 		struct gsm_state * S,
 		word 	xmaxcr,
@@ -197,6 +197,47 @@ static void Short_term_analysis_filtering P4((S,rp,k_n,s),
  *  needs to keep the array u[0..7] in memory for each call.
  */
 {
+#ifdef	GSM_SIMD
+	/*  The lattice as a wavefront: lane i runs stage i one sample
+	 *  behind lane i - 1, so all eight stages advance together.  A
+	 *  call takes k_n + 7 steps; lanes that are before the first or
+	 *  past the last sample leave their u[i] alone.
+	 */
+	__m128i	rpv  = _mm_loadu_si128( (__m128i *)rp );
+	__m128i	u    = _mm_loadu_si128( (__m128i *)S->u );
+	__m128i	lane = _mm_setr_epi16( 0, 1, 2, 3, 4, 5, 6, 7 );
+	__m128i	di   = _mm_setzero_si128();
+	__m128i	sav  = _mm_setzero_si128();
+	__m128i	ui, zzz, active;
+	int	t;
+
+	for (t = 0; t < k_n + 7; t++) {
+
+		int in = t < k_n ? s[t] : 0;
+
+		/* each stage takes the one below's outputs, stage 0 takes s[t] */
+		di  = _mm_insert_epi16( _mm_slli_si128( di,  2 ), in, 0 );
+		sav = _mm_insert_epi16( _mm_slli_si128( sav, 2 ), in, 0 );
+
+		active = _mm_andnot_si128(
+			_mm_cmpgt_epi16( lane, _mm_set1_epi16( (short)t ) ),
+			_mm_cmpgt_epi16( lane, _mm_set1_epi16( (short)(t - k_n) ) ));
+
+		ui  = u;
+		u   = _mm_or_si128( _mm_and_si128( active, sav ),
+				    _mm_andnot_si128( active, u ));
+
+		zzz = gsm_mult_r_epi16( rpv, di );
+		sav = _mm_adds_epi16( ui, zzz );
+
+		zzz = gsm_mult_r_epi16( rpv, ui );
+		di  = _mm_adds_epi16( di, zzz );
+
+		if (t >= 7) s[t - 7] = (word)_mm_extract_epi16( di, 7 );
+	}
+
+	_mm_storeu_si128( (__m128i *)S->u, u );
+#else	/* !GSM_SIMD */
 	register word		* u = S->u;
 	register int		i;
 	register word		di, zzz, ui, sav, rpi;
@@ -221,6 +262,7 @@ static void Short_term_analysis_filtering P4((S,rp,k_n,s),
 
 		*s = di;
 	}
+#endif	/* GSM_SIMD */
 }
 
 #if defined(USE_FLOAT_MUL) && defined(FAST)
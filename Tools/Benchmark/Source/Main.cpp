@@ -0,0 +1,695 @@
+/*
+  ==============================================================================
+
+    Benchmark entry point
+    - ns/sample and cycles/sample for each DSP unit in isolation, single-
+      threaded, at every sample rate and block size in the grid below
+    - each variant's speedup over its unit's first variant at the same rate
+      and block size (e.g. fast GSM over exact)
+    - optional JSON report so runs can be diffed against a baseline
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include "../../../Source/BrokenPlayer.h"
+#include "../../../Source/CircularBuffer.h"
+#include "../../../Source/LofiProcessors.h"
+#include "../../../Source/Modulators.h"
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+namespace
+{
+    constexpr std::array<double, 3> sampleRates { 44100.0, 48000.0, 96000.0 };
+    constexpr std::array<int, 8> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048 };
+    constexpr int numChannels { 2 };
+
+    // keeps the optimiser from discarding output nobody reads
+    volatile float sink { 0.0f };
+
+    // the time stamp counter on x86 (reference cycles, not core clocks); 0 elsewhere
+    inline uint64_t readCycleCounter() noexcept
+    {
+       #if JUCE_INTEL
+        return __rdtsc();
+       #else
+        return 0;
+       #endif
+    }
+
+    constexpr bool hasCycleCounter()
+    {
+       #if JUCE_INTEL
+        return true;
+       #else
+        return false;
+       #endif
+    }
+
+    struct Settings
+    {
+        int64_t samplesPerCase { 1 << 20 }; // per channel, after warmup
+        juce::String filter;
+        juce::File jsonFile;
+        bool writeJson { false };
+    };
+
+    struct Result
+    {
+        juce::String unit;
+        juce::String variant;
+        double sampleRate { 0.0 };
+        int blockSize { 0 };
+        double nsPerSample { 0.0 };
+        double cyclesPerSample { 0.0 };
+    };
+
+    // process() is called once per block on a buffer refilled with noise; it
+    // owns the unit under test, so each case starts from a freshly prepared one
+    using BlockFunction = std::function<void(juce::AudioBuffer<float>&)>;
+
+    struct BenchmarkCase
+    {
+        juce::String unit;
+        juce::String variant;
+        std::function<BlockFunction(double sampleRate, int blockSize)> prepare;
+    };
+
+    //==============================================================================
+    // per sample frame (all channels) of process(), including the block refill
+    Result measure(const BenchmarkCase& benchmarkCase, double sampleRate, int blockSize, const Settings& settings)
+    {
+        auto process = benchmarkCase.prepare(sampleRate, blockSize);
+
+        // a few seconds of noise, cycled through so the input never goes stale
+        constexpr int sourceBlocks { 64 };
+        juce::AudioBuffer<float> source (numChannels, blockSize * sourceBlocks);
+        juce::Random random { 1 };
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int sample = 0; sample < source.getNumSamples(); ++sample)
+                source.setSample(channel, sample, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+
+        juce::AudioBuffer<float> buffer (numChannels, blockSize);
+
+        const auto runBlock = [&](int64_t block)
+        {
+            const int offset = static_cast<int>(block % sourceBlocks) * blockSize;
+            for (int channel = 0; channel < numChannels; ++channel)
+                buffer.copyFrom(channel, 0, source, channel, offset, blockSize);
+
+            process(buffer);
+            sink = sink + buffer.getSample(0, blockSize - 1);
+        };
+
+        const int64_t numBlocks = std::max<int64_t>(8, settings.samplesPerCase / blockSize);
+
+        for (int64_t block = 0; block < numBlocks / 8; ++block)
+            runBlock(block);
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        const auto startCycles = readCycleCounter();
+
+        for (int64_t block = 0; block < numBlocks; ++block)
+            runBlock(block);
+
+        const auto elapsedCycles = readCycleCounter() - startCycles;
+        const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        const double numSamples = static_cast<double>(numBlocks) * blockSize;
+
+        Result result;
+        result.unit = benchmarkCase.unit;
+        result.variant = benchmarkCase.variant;
+        result.sampleRate = sampleRate;
+        result.blockSize = blockSize;
+        result.nsPerSample = elapsedSeconds * 1.0e9 / numSamples;
+        result.cyclesPerSample = static_cast<double>(elapsedCycles) / numSamples;
+        return result;
+    }
+
+    //==============================================================================
+    juce::dsp::ProcessSpec makeSpec(double sampleRate, int blockSize)
+    {
+        juce::dsp::ProcessSpec spec;
+        spec.sampleRate = sampleRate;
+        spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
+        spec.numChannels = numChannels;
+        return spec;
+    }
+
+    // a lofi processor with fixed parameters, as the player's distortion slot runs it
+    template <typename Processor>
+    BenchmarkCase makeLofiCase(const juce::String& unit, const juce::String& variant, LofiProcessorParameters params)
+    {
+        return { unit, variant, [params](double sampleRate, int blockSize) -> BlockFunction
+        {
+            auto processor = std::make_shared<Processor>();
+            processor->prepare(makeSpec(sampleRate, blockSize));
+            processor->setParameters(params);
+
+            return [processor](juce::AudioBuffer<float>& buffer)
+            {
+                juce::MidiBuffer midi;
+                processor->processBlock(buffer, midi);
+            };
+        }};
+    }
+
+    // writes each block in, then reads it back at a tape bend rate
+    BenchmarkCase makeCircularBufferCase(interpolationQuality quality, const juce::String& variant, float rate)
+    {
+        return { "CircularBuffer", variant, [quality, rate](double sampleRate, int blockSize) -> BlockFunction
+        {
+            auto circularBuffer = std::make_shared<CircularBuffer<float>>(static_cast<int>(sampleRate * 8.0));
+            circularBuffer->prepare(makeSpec(sampleRate, blockSize));
+            circularBuffer->setUsedBufferSegmentLength(static_cast<int>(sampleRate * 1.5));
+            circularBuffer->setInterpolationQuality(quality);
+
+            auto readPositions = std::make_shared<std::array<float, numChannels>>();
+            auto output = std::make_shared<std::vector<float>>(static_cast<size_t>(blockSize));
+            const float segmentLength = static_cast<float>(sampleRate * 1.5);
+
+            return [=](juce::AudioBuffer<float>& buffer)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    circularBuffer->fillNextBlock(channel, buffer.getNumSamples(), buffer.getReadPointer(channel));
+
+                    auto& position = (*readPositions)[static_cast<size_t>(channel)];
+                    position = std::fmod(circularBuffer->readBlock(channel, position, rate, buffer.getNumSamples(), output->data()), segmentLength);
+                    buffer.copyFrom(channel, 0, output->data(), buffer.getNumSamples());
+                }
+            };
+        }};
+    }
+
+    // one ramp per channel, retriggered whenever it lands
+    BenchmarkCase makeLineCase()
+    {
+        return { "Line", "ramp", [](double sampleRate, int) -> BlockFunction
+        {
+            auto lines = std::make_shared<std::array<Line<float>, numChannels>>();
+            for (auto& line : *lines)
+            {
+                line.reset(static_cast<float>(sampleRate));
+                line.setParameters(static_cast<float>(sampleRate * 0.05));
+                line.setDestination(1.0f);
+            }
+
+            return [lines](juce::AudioBuffer<float>& buffer)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    auto& line = (*lines)[static_cast<size_t>(channel)];
+                    auto* channelData = buffer.getWritePointer(channel);
+
+                    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+                        channelData[sample] *= line.renderAudioOutput();
+
+                    if (line.getRemainingRampSamples() == 0)
+                        line.setDestination(line.getDestination() > 0.5f ? 0.0f : 1.0f);
+                }
+            };
+        }};
+    }
+
+    // the same ramps through renderBlock(), scaling the block in one pass
+    BenchmarkCase makeLineBlockCase(rampShape shape, const juce::String& variant)
+    {
+        return { "Line", variant, [shape](double sampleRate, int blockSize) -> BlockFunction
+        {
+            auto lines = std::make_shared<std::array<Line<float>, numChannels>>();
+            for (auto& line : *lines)
+            {
+                line.reset(static_cast<float>(sampleRate));
+                line.setParameters(static_cast<float>(sampleRate * 0.05));
+                line.setShape(shape);
+                line.setDestination(1.0f);
+            }
+
+            auto ramp = std::make_shared<std::vector<float>>(static_cast<size_t>(blockSize));
+
+            return [lines, ramp](juce::AudioBuffer<float>& buffer)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    auto& line = (*lines)[static_cast<size_t>(channel)];
+
+                    line.renderBlock(ramp->data(), buffer.getNumSamples());
+                    juce::FloatVectorOperations::multiply(buffer.getWritePointer(channel), ramp->data(), buffer.getNumSamples());
+
+                    if (line.getRemainingRampSamples() == 0)
+                        line.setDestination(line.getDestination() > 0.5f ? 0.0f : 1.0f);
+                }
+            };
+        }};
+    }
+
+    BenchmarkCase makeLfoCase(generatorWaveform waveform, const juce::String& variant)
+    {
+        return { "LFO", variant, [waveform](double sampleRate, int) -> BlockFunction
+        {
+            OscillatorParameters params;
+            params.waveform = waveform;
+            params.frequency_Hz = 5.0;
+
+            auto lfos = std::make_shared<std::array<LFO<float>, numChannels>>();
+            for (auto& lfo : *lfos)
+            {
+                lfo.reset(static_cast<float>(sampleRate));
+                lfo.setParameters(params);
+            }
+
+            return [lfos](juce::AudioBuffer<float>& buffer)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    auto& lfo = (*lfos)[static_cast<size_t>(channel)];
+                    auto* channelData = buffer.getWritePointer(channel);
+
+                    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+                        channelData[sample] *= lfo.renderAudioOutput().normalOutput;
+                }
+            };
+        }};
+    }
+
+    // full depth, scaling the block as BrokenPlayer scales its playback rates
+    BenchmarkCase makeWowFlutterCase()
+    {
+        return { "WowFlutter", "full depth", [](double sampleRate, int) -> BlockFunction
+        {
+            auto wowFlutters = std::make_shared<std::array<WowFlutter, numChannels>>();
+            for (auto& wowFlutter : *wowFlutters)
+            {
+                wowFlutter.setDepth(1.0f);
+                wowFlutter.prepare(sampleRate, 1);
+            }
+
+            return [wowFlutters](juce::AudioBuffer<float>& buffer)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    (*wowFlutters)[static_cast<size_t>(channel)].applyToBlock(buffer.getWritePointer(channel), buffer.getNumSamples());
+            };
+        }};
+    }
+
+    // set up the way the plugin drives it, with its own clock and a fixed seed
+    BenchmarkCase makeBrokenPlayerCase(const juce::String& variant, float analogFX, float digitalFX, float lofiFX)
+    {
+        return { "BrokenPlayer", variant, [=](double sampleRate, int blockSize) -> BlockFunction
+        {
+            auto player = std::make_shared<BrokenPlayer>();
+            player->setRandomSeed(1);
+            player->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            player->prepareToPlay(sampleRate, blockSize);
+
+            player->setAnalogFX(analogFX);
+            player->setDigitalFX(digitalFX);
+            player->setLofiFX(lofiFX);
+            player->setDistortionType(0);
+            player->useExternalClock(false);
+            player->setClockSpeed(static_cast<int>(0.825 * sampleRate));
+            player->setBufferLength(static_cast<int>(sampleRate));
+            player->newNumRepeats(4);
+
+            return [player](juce::AudioBuffer<float>& buffer)
+            {
+                juce::MidiBuffer midi;
+                player->processBlock(buffer, midi);
+            };
+        }};
+    }
+
+    std::vector<BenchmarkCase> makeCases()
+    {
+        std::vector<BenchmarkCase> cases;
+
+        const std::array<std::pair<interpolationQuality, const char*>, 4> qualities
+        {{
+            { interpolationQuality::kLinear, "linear" },
+            { interpolationQuality::kHermite, "hermite" },
+            { interpolationQuality::kLagrange, "lagrange" },
+            { interpolationQuality::kSinc, "sinc" }
+        }};
+
+        // every interpolation tier at the tape bend rates that pick its sinc bands
+        for (const auto& [quality, name] : qualities)
+            for (const auto rate : { 0.5f, 1.0f, 1.5f, 2.0f })
+                cases.push_back(makeCircularBufferCase(quality, juce::String(name) + " x" + juce::String(rate, 1), rate));
+
+        LofiProcessorParameters params;
+        params.bitDepth = 8;
+        params.downsampling = 4;
+        cases.push_back(makeLofiCase<Bitcrusher>("Bitcrusher", "8 bit /4", params));
+
+        const std::array<std::pair<saturationKernel, const char*>, 3> kernels
+        {{
+            { saturationKernel::kTanh, "tanh" },
+            { saturationKernel::kPade, "rational" },
+            { saturationKernel::kTable, "table" }
+        }};
+
+        // every kernel with and without ADAA, at the top of the drive range the pulses pick
+        for (const auto& [kernel, name] : kernels)
+            for (const auto antiAliasing : { false, true })
+            {
+                params = {};
+                params.drive = 36.0f;
+                params.kernel = kernel;
+                params.antiAliasing = antiAliasing;
+                cases.push_back(makeLofiCase<SaturationProcessor>("SaturationProcessor", juce::String(name) + (antiAliasing ? " ADAA" : ""), params));
+            }
+
+        for (int factor = 1; factor <= 8; ++factor)
+        {
+            params = {};
+            params.downsampling = factor;
+            cases.push_back(makeLofiCase<MuLawProcessor>("MuLawProcessor", "/" + juce::String(factor), params));
+            cases.push_back(makeLofiCase<ALawProcessor>("ALawProcessor", "/" + juce::String(factor), params));
+            cases.push_back(makeLofiCase<AdpcmProcessor>("AdpcmProcessor", "/" + juce::String(factor), params));
+        }
+
+        const std::array<std::pair<gsmQuality, const char*>, 3> gsmQualities
+        {{
+            { gsmQuality::kExact, "exact" },
+            { gsmQuality::kFast, "fast" },
+            { gsmQuality::kFastLtpCut, "fast LTP cut" }
+        }};
+
+        // always 8 kHz inside, so its cost should barely move with the host rate
+        for (const auto& [quality, name] : gsmQualities)
+        {
+            params = {};
+            params.quality = quality;
+            cases.push_back(makeLofiCase<GSMProcessor>("GSMProcessor", name, params));
+        }
+
+        // the same work as exact, a stage at a time rather than whole frames
+        params = {};
+        params.spreadLoad = true;
+        cases.push_back(makeLofiCase<GSMProcessor>("GSMProcessor", "exact spread", params));
+
+        cases.push_back(makeLineCase());
+        cases.push_back(makeLineBlockCase(rampShape::kLinear, "block linear"));
+        cases.push_back(makeLineBlockCase(rampShape::kExponential, "block exponential"));
+        cases.push_back(makeLineBlockCase(rampShape::kSCurve, "block S-curve"));
+        cases.push_back(makeLfoCase(generatorWaveform::kSin, "sin"));
+        cases.push_back(makeLfoCase(generatorWaveform::kTriangle, "triangle"));
+        cases.push_back(makeWowFlutterCase());
+
+        cases.push_back(makeBrokenPlayerCase("defaults", 0.35f, 0.15f, 0.0f));
+        cases.push_back(makeBrokenPlayerCase("all effects", 0.8f, 0.8f, 0.8f));
+
+        return cases;
+    }
+
+    //==============================================================================
+    juce::String toJson(const std::vector<Result>& results)
+    {
+        juce::DynamicObject::Ptr machine = new juce::DynamicObject();
+        machine->setProperty("cpu", juce::SystemStats::getCpuModel());
+        machine->setProperty("cpuMHz", juce::SystemStats::getCpuSpeedInMegahertz());
+        machine->setProperty("os", juce::SystemStats::getOperatingSystemName());
+       #if JUCE_DEBUG
+        machine->setProperty("build", "debug");
+       #else
+        machine->setProperty("build", "release");
+       #endif
+
+        juce::Array<juce::var> entries;
+        for (const auto& result : results)
+        {
+            juce::DynamicObject::Ptr entry = new juce::DynamicObject();
+            entry->setProperty("unit", result.unit);
+            entry->setProperty("variant", result.variant);
+            entry->setProperty("sampleRate", result.sampleRate);
+            entry->setProperty("blockSize", result.blockSize);
+            entry->setProperty("nsPerSample", result.nsPerSample);
+            entry->setProperty("cyclesPerSample", hasCycleCounter() ? juce::var(result.cyclesPerSample) : juce::var());
+            entries.add(juce::var(entry.get()));
+        }
+
+        juce::DynamicObject::Ptr root = new juce::DynamicObject();
+        root->setProperty("machine", juce::var(machine.get()));
+        root->setProperty("channels", numChannels);
+        root->setProperty("results", entries);
+
+        return juce::JSON::toString(juce::var(root.get()));
+    }
+
+    //==============================================================================
+    // codes a sine, a square and noise at each GSM quality straight through libgsm;
+    // build without NDEBUG so its own asserts run too. "Fast" may lose a little
+    // against exact on the tones, a broken float path loses far more
+    bool checkGsmQualities()
+    {
+        constexpr int frameSize { 160 };
+        constexpr int numFrames { 50 };
+        const std::array<const char*, 3> signalNames { "sine", "square", "noise" };
+        std::map<std::pair<gsmQuality, int>, double> snrs;
+        bool passed { true };
+
+        for (const auto quality : { gsmQuality::kExact, gsmQuality::kFast, gsmQuality::kFastLtpCut })
+        {
+            for (int signal = 0; signal < static_cast<int>(signalNames.size()); ++signal)
+            {
+                // as gsm_create() leaves them
+                gsm_state encoder {};
+                gsm_state decoder {};
+                encoder.nrp = 40;
+                decoder.nrp = 40;
+
+                int fast = quality != gsmQuality::kExact ? 1 : 0;
+                int ltpCut = quality == gsmQuality::kFastLtpCut ? 1 : 0;
+                gsm_option(&encoder, GSM_OPT_FAST, &fast);
+                gsm_option(&encoder, GSM_OPT_LTP_CUT, &ltpCut);
+                gsm_option(&decoder, GSM_OPT_FAST, &fast);
+
+                juce::Random random { 1 };
+                double signalEnergy { 0.0 };
+                double errorEnergy { 0.0 };
+
+                for (int frame = 0; frame < numFrames; ++frame)
+                {
+                    std::array<gsm_signal, frameSize> input;
+                    std::array<gsm_signal, frameSize> output;
+                    gsm_frame coded;
+
+                    for (int sample = 0; sample < frameSize; ++sample)
+                    {
+                        const int n = frame * frameSize + sample;
+                        const double x = signal == 0 ? std::sin(n * 0.05)
+                                       : signal == 1 ? ((n / 40) % 2 == 0 ? 0.5 : -0.5)
+                                       : random.nextDouble() * 2.0 - 1.0;
+                        input[static_cast<size_t>(sample)] = static_cast<gsm_signal>(x * 16000.0);
+                    }
+
+                    gsm_encode(&encoder, input.data(), coded);
+                    gsm_decode(&decoder, coded, output.data());
+
+                    // past the first frames, once the predictors have settled
+                    if (frame < 2)
+                        continue;
+
+                    for (int sample = 0; sample < frameSize; ++sample)
+                    {
+                        const double in = input[static_cast<size_t>(sample)];
+                        const double error = in - output[static_cast<size_t>(sample)];
+                        signalEnergy += in * in;
+                        errorEnergy += error * error;
+                    }
+                }
+
+                snrs[{ quality, signal }] = 10.0 * std::log10(signalEnergy / std::max(errorEnergy, 1.0));
+            }
+        }
+
+        for (int signal = 0; signal < 2; ++signal)
+        {
+            const double exact = snrs[{ gsmQuality::kExact, signal }];
+            const double fast = snrs[{ gsmQuality::kFast, signal }];
+            const bool ok = fast > exact - 3.0;
+            passed = passed && ok;
+
+            std::cout << "GSM fast " << signalNames[static_cast<size_t>(signal)] << ": " << std::fixed << std::setprecision(1)
+                      << fast << " dB SNR against " << exact << " dB exact" << (ok ? "" : "  FAILED") << "\n";
+        }
+
+        return passed;
+    }
+
+    //==============================================================================
+    // exact GSM 06.10 must come out the same with or without the SSE2 kernels:
+    // silence, noise, a sine and clipped squares are coded at "Exact" and the
+    // frames hashed. The reference is from a libgsm build with GSM_NO_SIMD
+    constexpr uint64_t gsmReferenceHash { 0x107a7fd0c8e91fa0ull };
+
+    bool checkGsmBitExact()
+    {
+        constexpr int frameSize { 160 };
+        constexpr int framesPerSection { 50 };
+        constexpr int numFrames { 8 * framesPerSection };
+
+        // as gsm_create() leaves it
+        gsm_state encoder {};
+        encoder.nrp = 40;
+
+        // integer-only sources, so the input is the same on every platform and library
+        uint32_t seed { 1 };
+        int64_t cosine { 1 << 14 };
+        int64_t sine { 0 };
+        uint64_t hash { 0xcbf29ce484222325ull }; // FNV-1a
+
+        const auto clip = [](int64_t x) { return static_cast<gsm_signal>(std::clamp<int64_t>(x, -32768, 32767)); };
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            std::array<gsm_signal, frameSize> input;
+            gsm_frame coded;
+
+            for (int sample = 0; sample < frameSize; ++sample)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                const int64_t noise = static_cast<int16_t>(seed >> 16);
+
+                // a magic circle oscillator, a little under 500 Hz at 8 kHz
+                cosine -= sine * 3000 / 32768;
+                sine += cosine * 3000 / 32768;
+
+                const int n = frame * frameSize + sample;
+                const int64_t square = (n / 57) % 2 == 0 ? 48000 : -48000;
+
+                switch ((frame / framesPerSection) % 4)
+                {
+                    case 0: input[static_cast<size_t>(sample)] = 0; break;
+                    case 1: input[static_cast<size_t>(sample)] = clip(noise); break;
+                    case 2: input[static_cast<size_t>(sample)] = clip(sine + noise / 16); break;
+                    default: input[static_cast<size_t>(sample)] = clip(square + noise / 8); break;
+                }
+            }
+
+            gsm_encode(&encoder, input.data(), coded);
+
+            for (const auto byte : coded)
+                hash = (hash ^ byte) * 0x100000001b3ull;
+        }
+
+        const bool passed = hash == gsmReferenceHash;
+        std::cout << "GSM exact frames: hash " << std::hex << hash << ", reference " << gsmReferenceHash << std::dec
+                  << (passed ? "" : "  FAILED") << "\n";
+
+        return passed;
+    }
+
+    void printUsage()
+    {
+        std::cout << "usage: RSBrokenMediaBenchmark [options]\n"
+                     "  --filter=<text>       only units or variants containing text\n"
+                     "  --samples=<n>         samples per channel timed for each case (default 1048576)\n"
+                     "  --quick               an eighth of the default samples, for a smoke run\n"
+                     "  --json=<file>         also write every result as JSON\n"
+                     "  --check               only check exact GSM is bit exact and every quality codes real audio\n";
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    if (args.containsOption("--check"))
+    {
+        const bool bitExact = checkGsmBitExact();
+        const bool qualities = checkGsmQualities();
+        return bitExact && qualities ? 0 : 1;
+    }
+
+    //======== settings ========
+    Settings settings;
+
+    if (args.containsOption("--quick"))
+        settings.samplesPerCase /= 8;
+    if (args.containsOption("--samples"))
+        settings.samplesPerCase = std::max<int64_t>(2048, args.getValueForOption("--samples").getLargeIntValue());
+    if (args.containsOption("--filter"))
+        settings.filter = args.getValueForOption("--filter");
+    if (args.containsOption("--json"))
+    {
+        settings.jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--json"));
+        settings.writeJson = true;
+    }
+
+    //======== run ========
+    std::vector<Result> results;
+
+    // ns/sample of each unit's first variant, keyed by unit, rate and block size
+    std::map<juce::String, double> firstVariantTimes;
+
+    std::cout << std::left << std::setw(22) << "unit" << std::setw(16) << "variant" << std::right
+              << std::setw(8) << "rate" << std::setw(7) << "block" << std::setw(12) << "ns/sample"
+              << std::setw(14) << "cycles/sample" << std::setw(9) << "speedup" << "\n";
+
+    for (const auto& benchmarkCase : makeCases())
+    {
+        if (settings.filter.isNotEmpty() && ! benchmarkCase.unit.containsIgnoreCase(settings.filter)
+            && ! benchmarkCase.variant.containsIgnoreCase(settings.filter))
+            continue;
+
+        for (const auto sampleRate : sampleRates)
+        {
+            for (const auto blockSize : blockSizes)
+            {
+                const auto result = measure(benchmarkCase, sampleRate, blockSize, settings);
+                results.push_back(result);
+
+                std::cout << std::left << std::setw(22) << result.unit << std::setw(16) << result.variant << std::right
+                          << std::setw(8) << static_cast<int>(sampleRate) << std::setw(7) << blockSize << std::fixed
+                          << std::setw(12) << std::setprecision(2) << result.nsPerSample;
+
+                if (hasCycleCounter())
+                    std::cout << std::setw(14) << std::setprecision(1) << result.cyclesPerSample;
+                else
+                    std::cout << std::setw(14) << "-";
+
+                const auto key = result.unit + "/" + juce::String(static_cast<int>(sampleRate)) + "/" + juce::String(blockSize);
+                const auto reference = firstVariantTimes.emplace(key, result.nsPerSample).first->second;
+
+                std::cout << std::setw(8) << std::setprecision(2) << reference / std::max(result.nsPerSample, 1.0e-9) << "x";
+
+                std::cout << std::endl;
+            }
+        }
+    }
+
+    //======== report ========
+    if (settings.writeJson)
+    {
+        if (! settings.jsonFile.replaceWithText(toJson(results)))
+        {
+            std::cout << "could not write " << settings.jsonFile.getFullPathName() << "\n";
+            return 1;
+        }
+
+        std::cout << "wrote " << results.size() << " results to " << settings.jsonFile.getFullPathName() << "\n";
+    }
+
+    return 0;
+}
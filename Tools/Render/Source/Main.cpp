@@ -0,0 +1,350 @@
+/*
+  ==============================================================================
+
+    Offline render entry point
+    - runs RSBrokenMediaAudioProcessor headless over audio files, one
+      processor per worker thread, and reports the real-time factor
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include <numeric>
+#include "../../../Source/PluginProcessor.h"
+
+namespace
+{
+    struct RenderSettings
+    {
+        juce::File stateFile;
+        juce::File outputDirectory;
+        double sampleRate { 0.0 }; // 0 keeps each file's own rate
+        int blockSize { 512 };
+        int bitDepth { 24 };
+        double bpm { 120.0 };
+        int numThreads { 1 };
+        std::optional<uint64_t> seed;
+    };
+
+    //==============================================================================
+    // a transport that is always playing, advanced by the render loop
+    class OfflinePlayHead : public juce::AudioPlayHead
+    {
+    public:
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            const double seconds = static_cast<double>(mTimeInSamples) / mSampleRate;
+
+            PositionInfo info;
+            info.setIsPlaying(true);
+            info.setBpm(mBpm);
+            info.setTimeInSamples(mTimeInSamples);
+            info.setTimeInSeconds(seconds);
+            info.setPpqPosition(seconds * mBpm / 60.0);
+            return info;
+        }
+
+        void reset(double sampleRate, double bpm)
+        {
+            mSampleRate = sampleRate;
+            mBpm = bpm;
+            mTimeInSamples = 0;
+        }
+
+        void advance(int numSamples) { mTimeInSamples += numSamples; }
+
+    private:
+        double mSampleRate { 44100.0 };
+        double mBpm { 120.0 };
+        juce::int64 mTimeInSamples { 0 };
+    };
+
+    //==============================================================================
+    // one processor plus everything it needs to render a file
+    struct Worker
+    {
+        RSBrokenMediaAudioProcessor processor;
+        OfflinePlayHead playHead;
+        juce::AudioFormatManager formatManager;
+    };
+
+    juce::CriticalSection outputLock;
+
+    void log(const juce::String& message)
+    {
+        const juce::ScopedLock lock(outputLock);
+        std::cout << message << std::endl;
+    }
+
+    //==============================================================================
+    bool loadState(RSBrokenMediaAudioProcessor& processor, const juce::File& stateFile)
+    {
+        // same XML that getStateInformation() wraps, so it goes through the same path
+        auto xml = juce::XmlDocument::parse(stateFile);
+        if (xml == nullptr)
+            return false;
+
+        juce::MemoryBlock state;
+        juce::AudioProcessor::copyXmlToBinary(*xml, state);
+        processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        return true;
+    }
+
+    juce::AudioBuffer<float> resample(const juce::AudioBuffer<float>& input, double ratio)
+    {
+        const int numOutputSamples = static_cast<int>(std::ceil(input.getNumSamples() / ratio));
+        juce::AudioBuffer<float> output(input.getNumChannels(), numOutputSamples);
+
+        for (int channel = 0; channel < input.getNumChannels(); ++channel)
+        {
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process(ratio, input.getReadPointer(channel), output.getWritePointer(channel), numOutputSamples,
+                                 input.getNumSamples(), 0);
+        }
+
+        return output;
+    }
+
+    //==============================================================================
+    // renders one file; returns the seconds of audio written, or a negative value on failure
+    double renderFile(Worker& worker, const juce::File& inputFile, const RenderSettings& settings)
+    {
+        const auto outputFile = settings.outputDirectory.getChildFile(inputFile.getFileNameWithoutExtension() + ".wav");
+        if (outputFile == inputFile)
+        {
+            log("skipping " + inputFile.getFullPathName() + ": output would overwrite the input");
+            return -1.0;
+        }
+        
+        std::unique_ptr<juce::AudioFormatReader> reader (worker.formatManager.createReaderFor(inputFile));
+        if (reader == nullptr)
+        {
+            log("skipping " + inputFile.getFullPathName() + ": not a readable audio file");
+            return -1.0;
+        }
+
+        const int numChannels = static_cast<int>(reader->numChannels);
+        if (numChannels < 1 || numChannels > 2)
+        {
+            log("skipping " + inputFile.getFullPathName() + ": only mono and stereo files are supported");
+            return -1.0;
+        }
+
+        juce::AudioBuffer<float> audio(numChannels, static_cast<int>(reader->lengthInSamples));
+        reader->read(&audio, 0, audio.getNumSamples(), 0, true, numChannels > 1);
+
+        double sampleRate = reader->sampleRate;
+        if (settings.sampleRate > 0.0 && settings.sampleRate != sampleRate)
+        {
+            audio = resample(audio, sampleRate / settings.sampleRate);
+            sampleRate = settings.sampleRate;
+        }
+
+        //======== prepare ========
+        auto& processor = worker.processor;
+        const auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+
+        if (! processor.setBusesLayout(layout))
+        {
+            log("skipping " + inputFile.getFullPathName() + ": channel layout not supported");
+            return -1.0;
+        }
+
+        processor.setRandomSeed(settings.seed);
+        processor.setNonRealtime(true);
+        processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+        processor.prepareToPlay(sampleRate, settings.blockSize);
+        processor.reset();
+        worker.playHead.reset(sampleRate, settings.bpm);
+
+        //======== render in place, a block at a time ========
+        juce::MidiBuffer midi;
+        const int length = audio.getNumSamples();
+
+        const auto renderRange = [&](int begin, int end)
+        {
+            for (int start = begin; start < end; start += settings.blockSize)
+            {
+                const int numSamples = std::min(settings.blockSize, end - start);
+                juce::AudioBuffer<float> block(audio.getArrayOfWritePointers(), numChannels, start, numSamples);
+
+                processor.processBlock(block, midi);
+                worker.playHead.advance(numSamples);
+            }
+        };
+
+        renderRange(0, length);
+
+        // the plugin delays everything by the latency it reports, fixed at prepare,
+        // so run that much silence through and drop as much from the front
+        const int latency = processor.getLatencySamples();
+        if (latency > 0)
+        {
+            audio.setSize(numChannels, length + latency, true, true);
+            renderRange(length, length + latency);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* data = audio.getWritePointer(channel);
+                std::copy(data + latency, data + latency + length, data);
+            }
+
+            audio.setSize(numChannels, length, true);
+        }
+
+        processor.releaseResources();
+
+        //======== write ========
+        outputFile.deleteFile();
+
+        std::unique_ptr<juce::OutputStream> stream (outputFile.createOutputStream());
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+
+        if (stream != nullptr)
+            writer.reset(wavFormat.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                                                   settings.bitDepth, {}, 0));
+
+        if (writer == nullptr)
+        {
+            log("failed to write " + outputFile.getFullPathName());
+            return -1.0;
+        }
+
+        stream.release(); // now owned by the writer
+        writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+
+        return audio.getNumSamples() / sampleRate;
+    }
+
+    void printUsage()
+    {
+        std::cout << "usage: RSBrokenMediaRender --output=<dir> [options] <input files...>\n"
+                     "  --state=<file.xml>    parameter state, as saved by the plugin\n"
+                     "  --sample-rate=<Hz>    render rate (default: each file's own rate)\n"
+                     "  --block-size=<n>      samples per processBlock call (default 512)\n"
+                     "  --bits=<16|24|32>     output bit depth (default 24)\n"
+                     "  --bpm=<tempo>         transport tempo for DAW-synced clocks (default 120)\n"
+                     "  --threads=<n>         worker threads (default: one per core)\n"
+                     "  --seed=<n>            fixed random seed for repeatable renders\n";
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args (argc, argv);
+
+    //======== settings ========
+    RenderSettings settings;
+    settings.numThreads = juce::SystemStats::getNumCpus();
+
+    if (args.containsOption("--output"))
+        settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+    if (args.containsOption("--state"))
+        settings.stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--state"));
+    if (args.containsOption("--sample-rate"))
+        settings.sampleRate = args.getValueForOption("--sample-rate").getDoubleValue();
+    if (args.containsOption("--block-size"))
+        settings.blockSize = std::max(1, args.getValueForOption("--block-size").getIntValue());
+    if (args.containsOption("--bits"))
+        settings.bitDepth = args.getValueForOption("--bits").getIntValue();
+    if (args.containsOption("--bpm"))
+        settings.bpm = std::max(1.0, args.getValueForOption("--bpm").getDoubleValue());
+    if (args.containsOption("--threads"))
+        settings.numThreads = std::max(1, args.getValueForOption("--threads").getIntValue());
+    if (args.containsOption("--seed"))
+        settings.seed = static_cast<uint64_t>(args.getValueForOption("--seed").getLargeIntValue());
+
+    juce::Array<juce::File> inputFiles;
+    for (const auto& argument : args.arguments)
+        if (! argument.isOption())
+            inputFiles.add(argument.resolveAsFile());
+
+    if (inputFiles.isEmpty() || settings.outputDirectory == juce::File())
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (! settings.outputDirectory.createDirectory())
+    {
+        std::cout << "could not create " << settings.outputDirectory.getFullPathName() << "\n";
+        return 1;
+    }
+
+    //======== workers ========
+    // built here rather than on the pool so the processors' timers belong to the main thread
+    const int numWorkers = std::min(settings.numThreads, inputFiles.size());
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto worker = std::make_unique<Worker>();
+        worker->formatManager.registerBasicFormats();
+        worker->processor.setPlayHead(&worker->playHead);
+
+        if (settings.stateFile != juce::File() && ! loadState(worker->processor, settings.stateFile))
+        {
+            std::cout << "could not read state from " << settings.stateFile.getFullPathName() << "\n";
+            return 1;
+        }
+
+        workers.push_back(std::move(worker));
+    }
+
+    //======== render ========
+    // each worker pulls the next file until none are left
+    std::atomic<int> nextFile { 0 };
+    std::atomic<int> numFailed { 0 };
+    std::atomic<int> numWorkersRunning { numWorkers };
+    std::vector<double> audioSeconds (static_cast<size_t>(numWorkers), 0.0);
+    juce::WaitableEvent finished;
+
+    juce::ThreadPool pool (numWorkers);
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        pool.addJob([&, i]
+        {
+            for (int file = nextFile++; file < inputFiles.size(); file = nextFile++)
+            {
+                const auto fileStart = juce::Time::getHighResolutionTicks();
+                const double seconds = renderFile(*workers[static_cast<size_t>(i)], inputFiles[file], settings);
+                const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - fileStart);
+
+                if (seconds < 0.0)
+                {
+                    ++numFailed;
+                    continue;
+                }
+
+                audioSeconds[static_cast<size_t>(i)] += seconds;
+                log(inputFiles[file].getFileName() + ": " + juce::String(seconds, 2) + " s in " + juce::String(elapsed, 2)
+                    + " s (" + juce::String(seconds / elapsed, 1) + "x real time)");
+            }
+
+            if (--numWorkersRunning == 0)
+                finished.signal();
+        });
+    }
+
+    finished.wait();
+
+    //======== report ========
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    const double totalAudioSeconds = std::accumulate(audioSeconds.begin(), audioSeconds.end(), 0.0);
+
+    std::cout << "rendered " << (inputFiles.size() - numFailed.load()) << " of " << inputFiles.size() << " files, "
+              << juce::String(totalAudioSeconds, 2) << " s of audio in " << juce::String(wallSeconds, 2) << " s on "
+              << numWorkers << " thread(s): real-time factor " << juce::String(totalAudioSeconds / wallSeconds, 1) << "x\n";
+
+    return numFailed.load() == 0 ? 0 : 1;
+}